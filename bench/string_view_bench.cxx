@@ -0,0 +1,1319 @@
+/***********************************************
+** @Copyright (C) 2018 - 2019 Mohammed ELomari.
+** @brief Benchmarks the members of basic_string_view against
+**        std::basic_string_view, the searchers, ranges, parallel
+**        algorithms, hashes and interner built on it, and the UTF
+**        conversions.
+** \note  Every case is checked against std or a scalar equivalent
+**        before it is timed, a wrong answer stops the run.
+**        Prints one JSON result per line so two runs can be diffed, or
+**        checked against each other with --compare.
+**
+**        string_view_bench [--min-time SECONDS] [--repetitions N]
+**                          [--filter TEXT] [--file PATH]...
+**                          [--output PATH] [--compare PATH]
+**                          [--threshold PERCENT] [--quick]
+************************************************/
+#include <ci_string_view.hxx>
+#include <hash.hxx>
+#include <interner.hxx>
+#include <multi_searcher.hxx>
+#include <parallel.hxx>
+#include <split.hxx>
+#include <string_view.hxx>
+#include <unicode.hxx>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+
+// Built in the library, tells which kernels the run used
+namespace string_view_detail
+{
+bool cpu_has_avx2() noexcept;
+}
+
+
+namespace
+{
+
+// Options
+
+struct options
+{
+    double min_time = 0.01;         // seconds per timed run
+    int repetitions = 3;            // timed runs per case, the best one counts
+    std::string filter;             // only run the cases whose name contains it
+    std::vector<std::string> files; // extra corpora
+    std::string output;             // where to write the JSON, stdout if empty
+    std::string compare;            // earlier JSON to check for regressions
+    double threshold = 10.0;        // slowdown, in percent, reported by --compare
+};
+
+[[noreturn]] void usage(const char *program)
+{
+    std::cerr << "usage: " << program
+              << " [--min-time SECONDS] [--repetitions N] [--filter TEXT] [--file PATH]...\n"
+                 "       [--output PATH] [--compare PATH] [--threshold PERCENT] [--quick]\n";
+    std::exit(2);
+}
+
+options parse(int argc, char **argv)
+{
+    options opt;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const auto value = [&]() -> std::string {
+            if ((i + 1) >= argc) usage(argv[0]);
+            return argv[++i];
+        };
+
+        if (arg == "--min-time")         opt.min_time = std::stod(value());
+        else if (arg == "--repetitions") opt.repetitions = std::max(1, std::stoi(value()));
+        else if (arg == "--filter")      opt.filter = value();
+        else if (arg == "--file")        opt.files.push_back(value());
+        else if (arg == "--output")      opt.output = value();
+        else if (arg == "--compare")     opt.compare = value();
+        else if (arg == "--threshold")   opt.threshold = std::stod(value());
+        else if (arg == "--quick")       opt.min_time = 0.001, opt.repetitions = 1;
+        else usage(argv[0]);
+    }
+
+    return opt;
+}
+
+
+// Timing
+
+/***
+* @brief Keeps the compiler from dropping the computation of \p value
+****/
+template <typename T>
+inline void keep(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile T sink;
+    sink = value;
+#endif
+}
+
+/***
+* @brief Returns the best time of one call of \p f, in nanoseconds
+* \note  What \p f returns is kept alive, so the call cannot be elided.
+* \note  The number of calls per run grows until a run lasts min_time.
+****/
+template <typename F>
+double measure(F &&f, const options &opt)
+{
+    using clock = std::chrono::steady_clock;
+
+    const auto run = [&f](std::size_t iterations) {
+        const auto start = clock::now();
+        for (std::size_t i = 0UL; i < iterations; ++i) keep(f());
+        return std::chrono::duration<double>(clock::now() - start).count();
+    };
+
+    std::size_t iterations = 1UL;
+    double elapsed = run(iterations);
+
+    while ((elapsed < opt.min_time) && (iterations < (std::size_t(1) << 32U)))
+    {
+        const double scale = (elapsed > 0.0) ? (1.2 * opt.min_time / elapsed) : 10.0;
+        iterations = std::max(iterations * 2UL, static_cast<std::size_t>(static_cast<double>(iterations) * scale));
+        elapsed = run(iterations);
+    }
+
+    double best = elapsed;
+
+    for (int r = 1; r < opt.repetitions; ++r)
+    {
+        best = std::min(best, run(iterations));
+    }
+
+    return best * 1e9 / static_cast<double>(iterations);
+}
+
+
+// Corpora
+
+struct corpus
+{
+    std::string name;
+    std::string text;  // UTF-8, or raw bytes for --file
+};
+
+constexpr std::size_t corpus_bytes = (std::size_t(1) << 20U) + 4096UL;
+
+template <std::size_t N>
+const char *pick(std::mt19937_64 &rng, const char *const (&words)[N])
+{
+    return words[rng() % N];
+}
+
+std::string make_log(std::mt19937_64 &rng)
+{
+    static const char *const levels[] = {"INFO", "INFO", "INFO", "DEBUG", "WARN", "ERROR"};
+    static const char *const paths[]  = {"/api/v1/users", "/api/v1/orders/42", "/static/app.js",
+                                         "/healthz", "/api/v2/search?q=string+view", "/login"};
+    static const char *const verbs[]  = {"GET", "GET", "POST", "PUT", "DELETE"};
+
+    std::string text;
+    char line[256];
+
+    while (text.size() < corpus_bytes)
+    {
+        std::snprintf(line, sizeof(line),
+                      "2019-03-%02u T%02u:%02u:%02u.%03uZ %-5s [worker-%u] %s %s status=%u latency=%ums req=%016llx\n",
+                      unsigned(rng() % 28 + 1), unsigned(rng() % 24), unsigned(rng() % 60), unsigned(rng() % 60),
+                      unsigned(rng() % 1000), pick(rng, levels), unsigned(rng() % 16), pick(rng, verbs),
+                      pick(rng, paths), (rng() % 10 == 0) ? 500U : 200U, unsigned(rng() % 900),
+                      static_cast<unsigned long long>(rng()));
+        text += line;
+    }
+
+    return text;
+}
+
+std::string make_csv(std::mt19937_64 &rng)
+{
+    static const char *const names[]  = {"Alice", "Bob", "Carol", "Dave", "Eve", "Mallory", "Trent"};
+    static const char *const cities[] = {"Paris", "\"New York, NY\"", "Casablanca", "Tokyo", "Berlin"};
+
+    std::string text = "id,name,city,amount,date,active\n";
+    char row[160];
+
+    for (unsigned id = 1U; text.size() < corpus_bytes; ++id)
+    {
+        std::snprintf(row, sizeof(row), "%u,%s,%s,%u.%02u,2019-%02u-%02u,%s\n", id, pick(rng, names),
+                      pick(rng, cities), unsigned(rng() % 100000), unsigned(rng() % 100),
+                      unsigned(rng() % 12 + 1), unsigned(rng() % 28 + 1), (rng() % 2) ? "true" : "false");
+        text += row;
+    }
+
+    return text;
+}
+
+std::string make_utf8(std::mt19937_64 &rng)
+{
+    static const char *const words[] = {
+        "the", "view", "string", "search", "naïve", "café", "déjà", "Straße", "Ελληνικά", "λόγος",
+        "русский", "текст", "日本語", "文字列", "中文", "한국어", "עברית", "العربية", "emoji", "😀", "🚀"};
+
+    std::string text;
+
+    while (text.size() < corpus_bytes)
+    {
+        text += pick(rng, words);
+        text += (rng() % 12 == 0) ? ".\n" : " ";
+    }
+
+    return text;
+}
+
+std::string load_file(const std::string &path)
+{
+    std::ifstream in(path, std::ios::binary);
+
+    if (!in)
+    {
+        std::cerr << "cannot read " << path << '\n';
+        std::exit(1);
+    }
+
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+/***
+* @brief Returns the text of a corpus in the encoding of \p CharT
+* \note  UTF-8 for char, UTF-16 or UTF-32 for the others. Bytes that do
+*        not decode are widened one by one.
+****/
+template <typename CharT>
+std::basic_string<CharT> encode_as(const std::string &text)
+{
+    if constexpr (sizeof(CharT) == 1UL)
+    {
+        return text;
+    }
+    else
+    {
+        using unit = std::conditional_t<sizeof(CharT) == 2UL, char16_t, char32_t>;
+
+        std::vector<unit> buffer(text.size());
+        utf_result result{};
+
+        if constexpr (sizeof(CharT) == 2UL)
+            result = to_utf16(string_view(text.data(), text.size()), buffer.data(), buffer.size());
+        else
+            result = to_utf32(string_view(text.data(), text.size()), buffer.data(), buffer.size());
+
+        if (result.status != utf_status::ok)
+        {
+            return std::basic_string<CharT>(text.begin(), text.end());
+        }
+
+        return std::basic_string<CharT>(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(result.written));
+    }
+}
+
+template <typename CharT>
+const char *type_name()
+{
+    if constexpr (std::is_same_v<CharT, char>) return "char";
+    else if constexpr (std::is_same_v<CharT, wchar_t>) return "wchar_t";
+    else if constexpr (std::is_same_v<CharT, char16_t>) return "char16_t";
+    else return "char32_t";
+}
+
+
+// Results
+
+struct result
+{
+    std::string name;
+    std::string member;
+    std::string type;
+    std::string corpus;
+    std::size_t haystack;   // characters
+    std::size_t needle;     // characters, or set size
+    std::size_t bytes;      // bytes the member has to read, 0 when it reads none
+    double ns;
+    double baseline_ns;     // std::basic_string_view, NaN when there is none
+};
+
+/***
+* @brief The answer of a case that has no std counterpart to time
+****/
+template <typename T>
+struct expect
+{
+    T value;
+};
+
+template <typename T>
+inline constexpr bool is_expect = false;
+
+template <typename T>
+inline constexpr bool is_expect<expect<T>> = true;
+
+class suite final
+{
+public:
+    explicit suite(const options &opt) : m_options(opt) {}
+
+    /***
+    * @brief Checks \p ours against \p baseline, then times both
+    * \note  \p baseline is the same call on std::basic_string_view or a
+    *        scalar equivalent, an expect holding the answer when there is
+    *        nothing to time it against, or nullptr. A case whose answer
+    *        differs stops the run before it is timed.
+    ****/
+    template <typename Ours, typename Baseline>
+    void add(const char *member, const char *type, const std::string &corpus, std::size_t haystack,
+             std::size_t needle, std::size_t bytes, Ours &&ours, Baseline &&baseline)
+    {
+        std::string name = std::string(member) + '/' + type + '/' + corpus + '/'
+                         + std::to_string(haystack) + '/' + std::to_string(needle);
+
+        if (name.find(this->m_options.filter) == std::string::npos)
+        {
+            return;
+        }
+
+        double base = std::nan("");
+
+        if constexpr (is_expect<std::decay_t<Baseline>>)
+        {
+            suite::check(name, ours() == baseline.value);
+        }
+        else if constexpr (!std::is_same_v<std::decay_t<Baseline>, std::nullptr_t>)
+        {
+            suite::check(name, ours() == baseline());
+            base = measure(baseline, this->m_options);
+        }
+
+        const double ns = measure(ours, this->m_options);
+
+        this->m_results.push_back({std::move(name), member, type, corpus, haystack, needle, bytes, ns, base});
+    }
+
+    const std::vector<result> &results() const noexcept { return this->m_results; }
+
+    /***
+    * @brief Stops the run when a case got a wrong answer
+    ****/
+    static void check(const std::string &name, bool correct)
+    {
+        if (!correct)
+        {
+            std::cerr << "wrong result: " << name << '\n';
+            std::exit(1);
+        }
+    }
+
+private:
+    const options &m_options;
+    std::vector<result> m_results;
+};
+
+
+// Members
+
+template <typename CharT>
+void bench_members(suite &s, const corpus &c)
+{
+    using view     = basic_string_view<CharT>;
+    using std_view = std::basic_string_view<CharT>;
+    using string   = std::basic_string<CharT>;
+
+    const char *type = type_name<CharT>();
+    const string text = encode_as<CharT>(c.text);
+
+    for (const std::size_t wanted : {std::size_t(64), std::size_t(4096), std::size_t(1) << 20U})
+    {
+        const std::size_t size = std::min(wanted, text.size());
+
+        if ((size < 16UL) || ((wanted != size) && (wanted != 64UL) && (size <= 4096UL)))
+        {
+            continue;
+        }
+
+        const string hay_text = text.substr(0UL, size);
+        const string copy     = hay_text;  // equal contents, other buffer
+        const std::size_t bytes = size * sizeof(CharT);
+
+        const view hay(hay_text);
+        const std_view std_hay(hay_text);
+
+        for (const std::size_t m : {std::size_t(1), std::size_t(8), std::size_t(64), std::size_t(256)})
+        {
+            if ((m * 4UL) > size)
+            {
+                continue;
+            }
+
+            // Taken near the far end of the scan, so most of the haystack is read
+            const string forward  = hay_text.substr(size - (size / 16UL) - m, m);
+            const string backward = hay_text.substr(size / 16UL, m);
+
+            // What a search reads up to its match, used for the throughput
+            const std::size_t first = std_hay.find(std_view(forward)) + m;
+            const std::size_t last  = size - std_hay.rfind(std_view(backward));
+
+            if (m == 1UL)
+            {
+                const CharT f = forward[0];
+                const CharT b = backward[0];
+
+                s.add("find", type, c.name, size, m, first * sizeof(CharT),
+                      [&] { return hay.find(f); }, [&] { return std_hay.find(f); });
+                s.add("rfind", type, c.name, size, m, last * sizeof(CharT),
+                      [&] { return hay.rfind(b); }, [&] { return std_hay.rfind(b); });
+                continue;
+            }
+
+            const view fv(forward), bv(backward);
+            const std_view std_fv(forward), std_bv(backward);
+
+            s.add("find", type, c.name, size, m, first * sizeof(CharT),
+                  [&] { return hay.find(fv); }, [&] { return std_hay.find(std_fv); });
+            s.add("rfind", type, c.name, size, m, last * sizeof(CharT),
+                  [&] { return hay.rfind(bv); }, [&] { return std_hay.rfind(std_bv); });
+            s.add("contains", type, c.name, size, m, first * sizeof(CharT),
+                  [&] { return hay.contains(fv); }, [&] { return std_hay.find(std_fv) != std_view::npos; });
+        }
+
+        // Sets that the scans never stop on: absent characters for the
+        // *_of members, every character of the haystack for the *_not_of ones
+        const string absent = {CharT(1), CharT(2), CharT(3), CharT(4), CharT(5)};
+        string present(hay_text);
+        std::sort(present.begin(), present.end());
+        present.erase(std::unique(present.begin(), present.end()), present.end());
+
+        const view av(absent), pv(present);
+        const std_view std_av(absent), std_pv(present);
+
+        s.add("find_first_of", type, c.name, size, absent.size(), bytes,
+              [&] { return hay.find_first_of(av); }, [&] { return std_hay.find_first_of(std_av); });
+        s.add("find_last_of", type, c.name, size, absent.size(), bytes,
+              [&] { return hay.find_last_of(av); }, [&] { return std_hay.find_last_of(std_av); });
+        s.add("find_first_not_of", type, c.name, size, present.size(), bytes,
+              [&] { return hay.find_first_not_of(pv); }, [&] { return std_hay.find_first_not_of(std_pv); });
+        s.add("find_last_not_of", type, c.name, size, present.size(), bytes,
+              [&] { return hay.find_last_not_of(pv); }, [&] { return std_hay.find_last_not_of(std_pv); });
+
+        // The same scans with the set built once, up front
+        const basic_char_set<CharT> aset(av), pset(pv);
+
+        s.add("find_first_of_set", type, c.name, size, absent.size(), bytes,
+              [&] { return hay.find_first_of(aset); }, [&] { return std_hay.find_first_of(std_av); });
+        s.add("find_last_of_set", type, c.name, size, absent.size(), bytes,
+              [&] { return hay.find_last_of(aset); }, [&] { return std_hay.find_last_of(std_av); });
+        s.add("find_first_not_of_set", type, c.name, size, present.size(), bytes,
+              [&] { return hay.find_first_not_of(pset); }, [&] { return std_hay.find_first_not_of(std_pv); });
+        s.add("find_last_not_of_set", type, c.name, size, present.size(), bytes,
+              [&] { return hay.find_last_not_of(pset); }, [&] { return std_hay.find_last_not_of(std_pv); });
+
+        const view other(copy);
+        const std_view std_other(copy);
+        const view half(copy.data(), size / 2UL), tail(copy.data() + (size / 2UL), size - (size / 2UL));
+        const std_view std_half(copy.data(), size / 2UL), std_tail(copy.data() + (size / 2UL), size - (size / 2UL));
+
+        s.add("compare", type, c.name, size, size, bytes,
+              [&] { return hay.compare(other); }, [&] { return std_hay.compare(std_other); });
+        s.add("operator==", type, c.name, size, size, bytes,
+              [&] { return hay == other; }, [&] { return std_hay == std_other; });
+        s.add("operator==", type, c.name, size, size / 2UL, 0UL,
+              [&] { return hay == half; }, [&] { return std_hay == std_half; });
+        s.add("starts_with", type, c.name, size, half.size(), half.size() * sizeof(CharT),
+              [&] { return hay.starts_with(half); }, [&] { return std_hay.starts_with(std_half); });
+        s.add("ends_with", type, c.name, size, tail.size(), tail.size() * sizeof(CharT),
+              [&] { return hay.ends_with(tail); }, [&] { return std_hay.ends_with(std_tail); });
+    }
+}
+
+/***
+* @brief Long needles the text keeps almost matching
+* \note  Every candidate passes the first/last character filter and fails
+*        verification, which is where the search has to fall back to
+*        Two-Way to stay linear.
+****/
+template <typename CharT>
+void bench_long_needles(suite &s)
+{
+    using view     = basic_string_view<CharT>;
+    using std_view = std::basic_string_view<CharT>;
+    using string   = std::basic_string<CharT>;
+
+    const char *type = type_name<CharT>();
+
+    for (const std::size_t m : {std::size_t(64), std::size_t(1024)})
+    {
+        const std::size_t size = std::size_t(1) << 20U;
+
+        // "a..ab..ba" never occurs in a run of a's, yet starts and ends like it
+        string needle(m, CharT('a'));
+        needle[m / 2UL] = CharT('b');
+
+        const string hay_text(size, CharT('a'));
+        const view hay(hay_text), nv(needle);
+        const std_view std_hay(hay_text), std_nv(needle);
+
+        s.add("find", type, "almost", size, m, size * sizeof(CharT),
+              [&] { return hay.find(nv); }, [&] { return std_hay.find(std_nv); });
+        s.add("rfind", type, "almost", size, m, size * sizeof(CharT),
+              [&] { return hay.rfind(nv); }, [&] { return std_hay.rfind(std_nv); });
+    }
+}
+
+/***
+* @brief Long mixed-case needles a run of a's keeps almost matching
+* \note  The case-insensitive search has the same filter as the plain
+*        one and needs the same Two-Way fallback. Timed against std on
+*        the lower-cased needle, which has the same answer.
+****/
+void bench_ci_long_needles(suite &s)
+{
+    const std::size_t size = std::size_t(4) << 20U;
+    const std::string hay_text(size, 'a');
+
+    for (const std::size_t m : {std::size_t(64), std::size_t(1024), std::size_t(4096)})
+    {
+        std::string needle(m, 'a'), lower(m, 'a');
+
+        for (std::size_t i = 0UL; i < m; i += 2UL)
+        {
+            needle[i] = 'A';
+        }
+
+        needle[m / 2UL] = 'B';
+        lower[m / 2UL]  = 'b';
+
+        const ci_string_view hay(hay_text.data(), size), nv(needle.data(), m);
+        const std::string_view std_hay(hay_text), std_nv(lower);
+
+        s.add("ci_find", "char", "almost", size, m, size,
+              [&] { return hay.find(nv); }, [&] { return std_hay.find(std_nv); });
+        s.add("ci_rfind", "char", "almost", size, m, size,
+              [&] { return hay.rfind(nv); }, [&] { return std_hay.rfind(std_nv); });
+    }
+}
+
+/***
+* @brief The case-insensitive members, which std has no counterpart for
+****/
+void bench_case_insensitive(suite &s, const corpus &c)
+{
+    for (const std::size_t wanted : {std::size_t(64), std::size_t(4096), std::size_t(1) << 20U})
+    {
+        const std::size_t size = std::min(wanted, c.text.size());
+
+        if (size < 64UL)
+        {
+            continue;
+        }
+
+        const auto fold = [](std::string text, char first) {
+            std::transform(text.begin(), text.end(), text.begin(), [first](char ch) {
+                return ((ch >= first) && (ch <= char(first + 25))) ? char(ch ^ 0x20) : ch;
+            });
+            return text;
+        };
+
+        const std::string upper = fold(c.text.substr(0UL, size), 'a');
+        const std::string lower = fold(c.text.substr(0UL, size), 'A');
+
+        const ci_string_view hay(c.text.data(), size), other(upper.data(), upper.size());
+        const ci_string_view needle(c.text.data() + size - (size / 16UL) - 8UL, 8UL);
+        const ci_string_view backward(c.text.data() + (size / 16UL), 8UL);
+
+        // The answers, found with std in the lower-cased text
+        const std::string_view std_lower(lower);
+        const std::size_t found = std_lower.find(std_lower.substr(size - (size / 16UL) - 8UL, 8UL));
+        const std::size_t found_last = std_lower.rfind(std_lower.substr(size / 16UL, 8UL));
+
+        // What the searches read up to their match, as for the plain rows
+        const std::size_t first = found + needle.size();
+        const std::size_t last  = size - found_last;
+
+        s.add("ci_find", "char", c.name, size, needle.size(), first,
+              [&] { return hay.find(needle); }, expect{found});
+        s.add("ci_rfind", "char", c.name, size, backward.size(), last,
+              [&] { return hay.rfind(backward); }, expect{found_last});
+        s.add("ci_operator==", "char", c.name, size, size, size,
+              [&] { return hay == other; }, expect{true});
+    }
+}
+
+
+/***
+* @brief multi_searcher against one std search per needle
+* \note  8 needles fit the Teddy filter, 48 need the automaton. They are
+*        taken from the end of the text, so find reads most of it.
+****/
+template <typename CharT>
+void bench_multi(suite &s, const corpus &c)
+{
+    using view     = basic_string_view<CharT>;
+    using std_view = std::basic_string_view<CharT>;
+    using string   = std::basic_string<CharT>;
+    using match    = std::pair<std::size_t, std::size_t>;  // pattern, offset
+
+    const char *type = type_name<CharT>();
+    const string text = encode_as<CharT>(c.text);
+
+    for (const std::size_t wanted : {std::size_t(4096), std::size_t(1) << 20U})
+    {
+        const std::size_t size = std::min(wanted, text.size());
+
+        if ((size < 4096UL) || ((wanted != size) && (size <= 4096UL)))
+        {
+            continue;
+        }
+
+        const std::size_t tail = size / 16UL;
+        const view hay(text.data(), size);
+        const std_view std_hay(text.data(), size);
+
+        for (const std::size_t k : {std::size_t(8), std::size_t(48)})
+        {
+            std::vector<string> needles;
+
+            for (std::size_t i = 0UL; i < k; ++i)
+            {
+                needles.push_back(text.substr(size - tail + ((i * 7919UL) % (tail - 8UL)), 3UL + (i % 6UL)));
+            }
+
+            const multi_searcher<CharT> searcher(std::vector<view>(needles.begin(), needles.end()));
+
+            const auto naive_find = [&] {
+                match best{std_view::npos, std_view::npos};
+
+                for (std::size_t i = 0UL; i < k; ++i)
+                {
+                    const std::size_t at = std_hay.find(std_view(needles[i]));
+                    best = ((at != std_view::npos) && (at < best.second)) ? match{i, at} : best;
+                }
+
+                return best;
+            };
+
+            const auto naive_count = [&] {
+                std::size_t total = 0UL;
+
+                for (const string &needle : needles)
+                {
+                    for (std::size_t p = std_hay.find(std_view(needle)); p != std_view::npos;
+                         p = std_hay.find(std_view(needle), p + 1UL))
+                    {
+                        ++total;
+                    }
+                }
+
+                return total;
+            };
+
+            const match first = naive_find();
+
+            s.add("multi_find", type, c.name, size, k, (first.second + needles[first.first].size()) * sizeof(CharT),
+                  [&] {
+                      const auto m = searcher.find(hay);
+                      return match{m.pattern, m.offset};
+                  },
+                  naive_find);
+            s.add("multi_count", type, c.name, size, k, size * sizeof(CharT),
+                  [&] { return searcher.count(hay); }, naive_count);
+        }
+    }
+}
+
+/***
+* @brief Fields, lines and tokens, counted along with their total length
+****/
+using pieces = std::pair<std::size_t, std::size_t>;
+
+template <typename Range>
+pieces count_pieces(Range &&range)
+{
+    pieces total{0UL, 0UL};
+
+    for (const auto piece : range)
+    {
+        ++total.first;
+        total.second += piece.size();
+    }
+
+    return total;
+}
+
+template <typename CharT>
+pieces reference_split(std::basic_string_view<CharT> text, std::basic_string_view<CharT> delimiter)
+{
+    pieces total{0UL, 0UL};
+
+    // As std::views::split, an empty text has no field
+    if (text.empty())
+    {
+        return total;
+    }
+
+    for (std::size_t start = 0UL;; start += delimiter.size())
+    {
+        const std::size_t end = std::min(text.find(delimiter, start), text.size());
+
+        ++total.first;
+        total.second += end - start;
+
+        if ((start = end) == text.size())
+        {
+            return total;
+        }
+    }
+}
+
+template <typename CharT>
+pieces reference_lines(std::basic_string_view<CharT> text)
+{
+    pieces total{0UL, 0UL};
+
+    for (std::size_t start = 0UL; start < text.size();)
+    {
+        const std::size_t end = std::min(text.find(CharT('\n'), start), text.size());
+        const bool cr = (end > start) && (text[end - 1UL] == CharT('\r'));
+
+        ++total.first;
+        total.second += end - start - (cr ? 1UL : 0UL);
+        start = end + 1UL;
+    }
+
+    return total;
+}
+
+template <typename CharT>
+pieces reference_tokens(std::basic_string_view<CharT> text, std::basic_string_view<CharT> separators)
+{
+    pieces total{0UL, 0UL};
+
+    for (std::size_t start = text.find_first_not_of(separators); start < text.size();
+         start = text.find_first_not_of(separators, start))
+    {
+        const std::size_t end = std::min(text.find_first_of(separators, start), text.size());
+
+        ++total.first;
+        total.second += end - start;
+        start = end;
+    }
+
+    return total;
+}
+
+/***
+* @brief split, lines and tokens against the same loops written with std
+****/
+template <typename CharT>
+void bench_ranges(suite &s, const corpus &c)
+{
+    using view     = basic_string_view<CharT>;
+    using std_view = std::basic_string_view<CharT>;
+    using string   = std::basic_string<CharT>;
+
+    const char *type = type_name<CharT>();
+    const string text = encode_as<CharT>(c.text);
+    const std::size_t bytes = text.size() * sizeof(CharT);
+
+    const view hay(text);
+    const std_view std_hay(text);
+
+    const CharT comma = CharT(',');
+    const string word = {CharT('s'), CharT('t')};
+    const string separators = {CharT(' '), CharT(','), CharT('\n'), CharT('=')};
+    const basic_char_set<CharT> set(separators.data(), separators.size());
+
+    s.add("split_char", type, c.name, text.size(), 1UL, bytes,
+          [&] { return count_pieces(split(hay, comma)); },
+          [&] { return reference_split(std_hay, std_view(&comma, 1UL)); });
+    s.add("split", type, c.name, text.size(), word.size(), bytes,
+          [&] { return count_pieces(split(hay, view(word))); },
+          [&] { return reference_split(std_hay, std_view(word)); });
+    s.add("lines", type, c.name, text.size(), 1UL, bytes,
+          [&] { return count_pieces(lines(hay)); },
+          [&] { return reference_lines(std_hay); });
+    s.add("tokens", type, c.name, text.size(), separators.size(), bytes,
+          [&] { return count_pieces(tokens(hay, set)); },
+          [&] { return reference_tokens(std_hay, std_view(separators)); });
+}
+
+/***
+* @brief The parallel algorithms over the text repeated to 16 MiB, against
+*        a single-threaded std scan
+* \note  The copies make the needles recur, so the one parallel_find looks
+*        for is only put at the very end.
+****/
+template <typename CharT>
+void bench_parallel(suite &s, const corpus &c)
+{
+    using view     = basic_string_view<CharT>;
+    using std_view = std::basic_string_view<CharT>;
+    using string   = std::basic_string<CharT>;
+
+    const char *type = type_name<CharT>();
+    const string text = encode_as<CharT>(c.text);
+
+    if (text.size() < 4096UL)
+    {
+        return;
+    }
+
+    const string marker = encode_as<CharT>("<<the one at the end>>");
+
+    string hay_text;
+
+    while ((hay_text.size() * sizeof(CharT)) < (std::size_t(16) << 20U))
+    {
+        hay_text += text;
+    }
+
+    hay_text += marker;
+
+    const std::size_t size  = hay_text.size();
+    const std::size_t bytes = size * sizeof(CharT);
+
+    const string word = text.substr(text.size() / 2UL, 4UL);
+    const CharT newline = CharT('\n');
+
+    const view hay(hay_text), wv(word), mv(marker);
+    const std_view std_hay(hay_text), std_wv(word), std_mv(marker);
+
+    const auto all = [&] {
+        std::vector<std::size_t> found;
+
+        for (std::size_t p = std_hay.find(std_wv); p != std_view::npos; p = std_hay.find(std_wv, p + 1UL))
+        {
+            found.push_back(p);
+        }
+
+        return found;
+    };
+
+    s.add("parallel_find", type, c.name, size, marker.size(), bytes,
+          [&] { return parallel_find(hay, mv); }, [&] { return std_hay.find(std_mv); });
+    s.add("parallel_count", type, c.name, size, word.size(), bytes,
+          [&] { return parallel_count(hay, wv); }, [&] { return all().size(); });
+    s.add("parallel_count_char", type, c.name, size, 1UL, bytes,
+          [&] { return parallel_count(hay, newline); },
+          [&] { return static_cast<std::size_t>(std::count(std_hay.begin(), std_hay.end(), newline)); });
+    s.add("parallel_find_all", type, c.name, size, word.size(), bytes,
+          [&] {
+              std::vector<std::size_t> found;
+              parallel_find_all(hay, wv, std::back_inserter(found));
+              return found;
+          },
+          all);
+    s.add("parallel_for_each_line", type, c.name, size, 1UL, bytes,
+          [&] {
+              std::atomic<std::size_t> count{0UL}, total{0UL};
+
+              parallel_for_each_line(hay, [&](view line) {
+                  count.fetch_add(1UL, std::memory_order_relaxed);
+                  total.fetch_add(line.size(), std::memory_order_relaxed);
+              });
+
+              return pieces{count.load(), total.load()};
+          },
+          [&] { return reference_lines(std_hay); });
+}
+
+/***
+* @brief hash_value over the short, medium and striped paths, and lookups
+*        through the transparent functors
+* \note  Each hash is checked against std::hash of a copy one character
+*        off, so the kernels must agree whatever the alignment.
+****/
+template <typename CharT>
+void bench_hash(suite &s, const corpus &c)
+{
+    using view   = basic_string_view<CharT>;
+    using string = std::basic_string<CharT>;
+
+    const char *type = type_name<CharT>();
+    const string text = encode_as<CharT>(c.text);
+
+    for (const std::size_t wanted : {std::size_t(8), std::size_t(64), std::size_t(4096), std::size_t(1) << 20U})
+    {
+        const std::size_t size = std::min(wanted / sizeof(CharT), text.size());
+
+        if ((size == 0UL) || ((size != (wanted / sizeof(CharT))) && (size <= (4096UL / sizeof(CharT)))))
+        {
+            continue;
+        }
+
+        const string shifted = CharT('x') + text.substr(0UL, size);
+        const view v(text.data(), size);
+        const std::size_t other = std::hash<view>()(view(shifted.data() + 1UL, size));
+
+        s.add("hash_value", type, c.name, size, 0UL, size * sizeof(CharT),
+              [&] { return static_cast<std::size_t>(hash_value(v)); }, expect{other});
+    }
+
+    // The lines as keys, probed with views into the text and no temporary string
+    std::vector<view> probes;
+
+    for (const view line : lines(view(text)))
+    {
+        probes.push_back(line);
+
+        if (probes.size() == 1024UL)
+        {
+            break;
+        }
+    }
+
+    std::unordered_set<string, basic_string_view_hash<CharT>, basic_string_view_equal<CharT>> ours;
+    std::unordered_set<string> theirs;
+
+    for (std::size_t i = 0UL; i < probes.size(); i += 2UL)
+    {
+        ours.emplace(probes[i].data(), probes[i].size());
+        theirs.emplace(probes[i].data(), probes[i].size());
+    }
+
+    s.add("hash_lookup", type, c.name, probes.size(), ours.size(), 0UL,
+          [&] {
+              return static_cast<std::size_t>(std::count_if(probes.begin(), probes.end(), [&](view probe) {
+                  return ours.find(probe) != ours.end();
+              }));
+          },
+          [&] {
+              return static_cast<std::size_t>(std::count_if(probes.begin(), probes.end(), [&](view probe) {
+                  return theirs.find(string(probe.data(), probe.size())) != theirs.end();
+              }));
+          });
+}
+
+
+/***
+* @brief Interning the lines of a text once they are all held
+* \note  Checks first that moving an interner keeps the views it handed
+*        out and leaves the source empty and usable.
+****/
+template <typename CharT>
+void bench_interner(suite &s, const corpus &c)
+{
+    using view     = basic_string_view<CharT>;
+    using std_view = std::basic_string_view<CharT>;
+    using string   = std::basic_string<CharT>;
+
+    const char *type = type_name<CharT>();
+    const string text = encode_as<CharT>(c.text);
+
+    std::vector<view> probes;
+
+    for (const view line : lines(view(text)))
+    {
+        probes.push_back(line);
+
+        if (probes.size() == 4096UL)
+        {
+            break;
+        }
+    }
+
+    if (probes.size() < 2UL)
+    {
+        return;
+    }
+
+    const std::string name = std::string("intern/") + type + '/' + c.name;
+    const auto same_text = [](view lhs, view rhs) {
+        return std_view(lhs.data(), lhs.size()) == std_view(rhs.data(), rhs.size());
+    };
+
+    basic_interner<CharT> moved_from;
+    const view kept = moved_from.intern(probes[0]);
+
+    basic_interner<CharT> pool(std::move(moved_from));
+
+    suite::check(name + "/moved_from", moved_from.empty() && (moved_from.memory() == 0UL));
+    suite::check(name + "/moved_from", moved_from.find(probes[0]).data() == nullptr);
+    suite::check(name + "/moved_from", same_text(moved_from.intern(probes[1]), probes[1]) && (moved_from.size() == 1UL));
+    suite::check(name + "/moved_from", same_text(pool.intern(probes[1]), probes[1]) && same_text(kept, probes[0]));
+
+    moved_from = std::move(pool);
+
+    suite::check(name + "/moved_from", pool.empty() && (moved_from.size() == 2UL) && same_text(kept, probes[0]));
+    suite::check(name + "/moved_from", same_text(pool.intern(probes[0]), probes[0]) && (pool.size() == 1UL));
+
+    // The answer is the number of distinct lines
+    basic_interner<CharT> interner;
+    std::unordered_set<std_view> distinct;
+
+    for (const view probe : probes)
+    {
+        interner.intern(probe);
+        distinct.emplace(probe.data(), probe.size());
+    }
+
+    s.add("intern", type, c.name, probes.size(), distinct.size(), 0UL,
+          [&] {
+              for (const view probe : probes)
+              {
+                  interner.intern(probe);
+              }
+
+              return interner.size();
+          },
+          expect{distinct.size()});
+}
+
+
+// Conversions
+
+/***
+* @brief Decodes valid UTF-8 one code point at a time, the reference the
+*        conversions are checked against
+****/
+std::u32string reference_utf32(const std::string &text)
+{
+    std::u32string out;
+
+    for (std::size_t i = 0UL; i < text.size();)
+    {
+        const auto lead = static_cast<unsigned char>(text[i]);
+        const std::size_t n = (lead < 0x80U) ? 1UL : (lead < 0xE0U) ? 2UL : (lead < 0xF0U) ? 3UL : 4UL;
+
+        char32_t cp = (n == 1UL) ? lead : (lead & (0x7FU >> n));
+
+        for (std::size_t k = 1UL; k < n; ++k)
+        {
+            cp = (cp << 6U) | (static_cast<unsigned char>(text[i + k]) & 0x3FU);
+        }
+
+        out.push_back(cp);
+        i += n;
+    }
+
+    return out;
+}
+
+std::u16string reference_utf16(const std::u32string &text)
+{
+    std::u16string out;
+
+    for (const char32_t cp : text)
+    {
+        if (cp < 0x10000U)
+        {
+            out.push_back(static_cast<char16_t>(cp));
+        }
+        else
+        {
+            out.push_back(static_cast<char16_t>(0xD800U + ((cp - 0x10000U) >> 10U)));
+            out.push_back(static_cast<char16_t>(0xDC00U + ((cp - 0x10000U) & 0x3FFU)));
+        }
+    }
+
+    return out;
+}
+
+void bench_conversions(suite &s, const corpus &c)
+{
+    if (!is_valid_utf8(string_view(c.text.data(), c.text.size())))
+    {
+        return;
+    }
+
+    const std::u32string utf32 = reference_utf32(c.text);
+    const std::u16string utf16 = reference_utf16(utf32);
+
+    std::vector<char> out8(c.text.size() + 16UL);
+    std::vector<char16_t> out16(utf16.size() + 16UL);
+    std::vector<char32_t> out32(utf32.size() + 16UL);
+
+    const string_view text(c.text.data(), c.text.size());
+    const u16string_view text16(utf16.data(), utf16.size());
+    const u32string_view text32(utf32.data(), utf32.size());
+
+    const std::size_t n = text.size();
+    const auto run = [&](const char *member, const char *type, std::size_t units, std::size_t bytes, auto &&f,
+                         auto answer) {
+        s.add(member, type, c.name, units, 0UL, bytes, f, expect{answer});
+    };
+
+    // The transcoders hand back what they wrote, compared in full with the reference
+    const std::string_view want8(c.text);
+    const std::u16string_view want16(utf16);
+    const std::u32string_view want32(utf32);
+
+    run("is_valid_utf8", "char", n, n, [&] { return is_valid_utf8(text); }, true);
+    run("is_valid_utf16", "char16_t", text16.size(), text16.size() * 2UL, [&] { return is_valid_utf16(text16); }, true);
+    run("is_valid_utf32", "char32_t", text32.size(), text32.size() * 4UL, [&] { return is_valid_utf32(text32); }, true);
+    run("utf16_length", "char", n, n, [&] { return utf16_length(text); }, utf16.size());
+    run("utf8_length", "char16_t", text16.size(), text16.size() * 2UL, [&] { return utf8_length(text16); }, n);
+    run("to_utf16", "char", n, n,
+        [&] { return std::u16string_view(out16.data(), to_utf16(text, out16.data(), out16.size()).written); }, want16);
+    run("to_utf32", "char", n, n,
+        [&] { return std::u32string_view(out32.data(), to_utf32(text, out32.data(), out32.size()).written); }, want32);
+    run("to_utf8", "char16_t", text16.size(), text16.size() * 2UL,
+        [&] { return std::string_view(out8.data(), to_utf8(text16, out8.data(), out8.size()).written); }, want8);
+    run("to_utf32", "char16_t", text16.size(), text16.size() * 2UL,
+        [&] { return std::u32string_view(out32.data(), to_utf32(text16, out32.data(), out32.size()).written); }, want32);
+    run("to_utf8", "char32_t", text32.size(), text32.size() * 4UL,
+        [&] { return std::string_view(out8.data(), to_utf8(text32, out8.data(), out8.size()).written); }, want8);
+    run("to_utf16", "char32_t", text32.size(), text32.size() * 4UL,
+        [&] { return std::u16string_view(out16.data(), to_utf16(text32, out16.data(), out16.size()).written); }, want16);
+}
+
+
+// Output
+
+std::string number(double value)
+{
+    if (std::isnan(value))
+    {
+        return "null";
+    }
+
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.3f", value);
+    return text;
+}
+
+void write_json(std::ostream &out, const options &opt, const std::vector<result> &results)
+{
+#if defined(STRING_VIEW_INSTRUMENT)
+    constexpr bool instrumented = true;
+#else
+    constexpr bool instrumented = false;
+#endif
+#if defined(STRING_VIEW_INSTRUMENT_TIMERS)
+    constexpr bool timed = true;
+#else
+    constexpr bool timed = false;
+#endif
+
+    out << "{\n"
+        << "  \"library\": \"string_view_l\",\n"
+        << "  \"config\": {\"min_time\": " << number(opt.min_time) << ", \"repetitions\": " << opt.repetitions
+        << ", \"avx2\": " << (string_view_detail::cpu_has_avx2() ? "true" : "false")
+        << ", \"instrument\": " << (instrumented ? "true" : "false")
+        << ", \"timers\": " << (timed ? "true" : "false") << "},\n"
+        << "  \"results\": [\n";
+
+    for (std::size_t i = 0UL; i < results.size(); ++i)
+    {
+        const result &r = results[i];
+        const double gbps = ((r.bytes != 0UL) && (r.ns > 0.0)) ? (static_cast<double>(r.bytes) / r.ns) : std::nan("");
+
+        out << "    {\"name\": \"" << r.name << "\", \"member\": \"" << r.member << "\", \"type\": \"" << r.type
+            << "\", \"corpus\": \"" << r.corpus << "\", \"haystack\": " << r.haystack
+            << ", \"needle\": " << r.needle << ", \"ns\": " << number(r.ns) << ", \"gbps\": " << number(gbps)
+            << ", \"baseline_ns\": " << number(r.baseline_ns)
+            << ", \"speedup\": " << number(r.baseline_ns / r.ns) << '}'
+            << ((i + 1UL) < results.size() ? ",\n" : "\n");
+    }
+
+    out << "  ]";
+
+#if defined(STRING_VIEW_INSTRUMENT)
+    out << ",\n  \"instrumentation\": [\n";
+
+    for (std::size_t i = 0UL; i < instrumented_member_count; ++i)
+    {
+        const auto member = static_cast<instrumented_member>(i);
+        const instrument_counters &counters = instrument_counters_of(member);
+
+        out << "    {\"member\": \"" << instrument_name(member) << "\", \"calls\": " << counters.calls.load()
+            << ", \"bytes\": " << counters.bytes.load() << ", \"verifications\": " << counters.verifications.load()
+            << ", \"nanoseconds\": " << counters.nanoseconds.load() << '}'
+            << ((i + 1UL) < instrumented_member_count ? ",\n" : "\n");
+    }
+
+    out << "  ]";
+#endif
+
+    out << "\n}\n";
+}
+
+/***
+* @brief Reports the cases that got slower than in an earlier run
+* \note  Reads back the name and ns fields of the lines write_json wrote,
+*        cases missing from either run are skipped.
+* @return the number of regressions
+****/
+std::size_t compare_runs(const options &opt, const std::vector<result> &results)
+{
+    std::ifstream in(opt.compare);
+
+    if (!in)
+    {
+        std::cerr << "cannot read " << opt.compare << '\n';
+        std::exit(1);
+    }
+
+    std::map<std::string, double> previous;
+
+    for (std::string line; std::getline(in, line);)
+    {
+        const std::string name_key = "\"name\": \"";
+        const std::string ns_key   = "\"ns\": ";
+
+        const auto name = line.find(name_key);
+        const auto ns   = line.find(ns_key);
+
+        if ((name != std::string::npos) && (ns != std::string::npos))
+        {
+            const auto first = name + name_key.size();
+            previous[line.substr(first, line.find('"', first) - first)] = std::atof(line.c_str() + ns + ns_key.size());
+        }
+    }
+
+    std::size_t regressions = 0UL;
+
+    for (const result &r : results)
+    {
+        const auto it = previous.find(r.name);
+
+        if ((it == previous.end()) || (it->second <= 0.0))
+        {
+            continue;
+        }
+
+        const double change = 100.0 * (r.ns - it->second) / it->second;
+
+        // Below a nanosecond the difference is the clock, not the code
+        if ((change > opt.threshold) && ((r.ns - it->second) > 1.0))
+        {
+            std::cerr << "slower: " << r.name << ' ' << number(it->second) << " ns -> " << number(r.ns)
+                      << " ns (+" << number(change) << "%)\n";
+            ++regressions;
+        }
+    }
+
+    std::cerr << regressions << " regression(s) over " << number(opt.threshold) << "%\n";
+    return regressions;
+}
+
+}  // namespace
+
+
+auto main(int argc, char **argv) -> int
+{
+    const options opt = parse(argc, argv);
+
+    std::mt19937_64 rng(20190101UL);
+    std::vector<corpus> corpora = {{"log", make_log(rng)}, {"csv", make_csv(rng)}, {"utf8", make_utf8(rng)}};
+
+    for (const std::string &path : opt.files)
+    {
+        corpora.push_back({path.substr(path.find_last_of('/') + 1UL), load_file(path)});
+    }
+
+    suite s(opt);
+
+#if defined(STRING_VIEW_INSTRUMENT)
+    instrument_reset();
+#endif
+
+    for (const corpus &c : corpora)
+    {
+        bench_members<char>(s, c);
+        bench_members<wchar_t>(s, c);
+        bench_members<char16_t>(s, c);
+        bench_members<char32_t>(s, c);
+        bench_multi<char>(s, c);
+        bench_multi<char16_t>(s, c);
+        bench_multi<char32_t>(s, c);
+        bench_ranges<char>(s, c);
+        bench_ranges<wchar_t>(s, c);
+        bench_ranges<char16_t>(s, c);
+        bench_ranges<char32_t>(s, c);
+        bench_parallel<char>(s, c);
+        bench_parallel<char32_t>(s, c);
+        bench_hash<char>(s, c);
+        bench_hash<wchar_t>(s, c);
+        bench_hash<char16_t>(s, c);
+        bench_hash<char32_t>(s, c);
+        bench_interner<char>(s, c);
+        bench_interner<char32_t>(s, c);
+        bench_case_insensitive(s, c);
+        bench_conversions(s, c);
+    }
+
+    bench_long_needles<char>(s);
+    bench_long_needles<wchar_t>(s);
+    bench_long_needles<char16_t>(s);
+    bench_long_needles<char32_t>(s);
+    bench_ci_long_needles(s);
+
+    if (opt.output.empty())
+    {
+        write_json(std::cout, opt, s.results());
+    }
+    else
+    {
+        std::ofstream out(opt.output);
+        write_json(out, opt, s.results());
+    }
+
+    return (!opt.compare.empty() && (compare_runs(opt, s.results()) != 0UL)) ? 1 : 0;
+}
@@ -0,0 +1,416 @@
+/***********************************************
+** @Copyright (C) 2018 - 2019 Mohammed ELomari.
+** @brief A precompiled set of characters for the find_*_of family.
+************************************************/
+#ifndef CHAR_SET_HXX
+#define CHAR_SET_HXX
+
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+
+template <typename CharT, typename Traits>
+class basic_string_view;
+
+template <typename CharT>
+class basic_char_set;
+
+
+namespace string_view_detail
+{
+
+/***
+* @brief Finds the first character of \p s that is (or is not) in \p set
+* @param s      the characters to scan
+* @param n      number of characters in \p s
+* @param set    the characters to look for
+* @param negate whether to look for the first character not in \p set
+* @return the position of the character, or npos
+****/
+std::size_t find_in_set(const char *s, std::size_t n,
+                        const basic_char_set<char> &set, bool negate) noexcept;
+
+/***
+* @brief Finds the last character of \p s that is (or is not) in \p set
+* @param s      the characters to scan
+* @param n      number of characters in \p s
+* @param set    the characters to look for
+* @param negate whether to look for the last character not in \p set
+* @return the position of the character, or npos
+****/
+std::size_t rfind_in_set(const char *s, std::size_t n,
+                         const basic_char_set<char> &set, bool negate) noexcept;
+
+/***
+* @brief Overloads for the wider characters, which classify the characters
+*        below 256 a vector at a time and look the others up in the set
+****/
+template <typename CharT>
+std::size_t find_in_set(const CharT *s, std::size_t n,
+                        const basic_char_set<CharT> &set, bool negate) noexcept;
+
+template <typename CharT>
+std::size_t rfind_in_set(const CharT *s, std::size_t n,
+                         const basic_char_set<CharT> &set, bool negate) noexcept;
+
+/***
+* @brief Hashes a character of 256 or more into the filter of a set
+****/
+inline constexpr std::size_t char_set_hash(std::uint32_t u) noexcept
+{
+    return static_cast<std::size_t>((u ^ (u >> 8U) ^ (u >> 16U)) & 0xFFU);
+}
+
+/***
+* @brief Consecutive wide members of a set, both ends included
+****/
+template <typename UnsignedT>
+struct char_range
+{
+    UnsignedT first;
+    UnsignedT last;
+};
+
+/***
+* @brief Binary search of sorted, disjoint ranges
+* @return true if one of the \p count ranges holds \p u
+****/
+template <typename UnsignedT>
+constexpr bool in_ranges(const char_range<UnsignedT> *ranges, std::size_t count, UnsignedT u) noexcept
+{
+    // The last range starting at or before u is the only one that may hold
+    // it. Both halves keep the same length, so the step compiles to a cmov.
+    while (count > 1UL)
+    {
+        const std::size_t half = count / 2UL;
+
+        ranges = (ranges[half].first <= u) ? (ranges + half) : ranges;
+        count -= half;
+    }
+
+    return (count == 1UL) && (ranges->first <= u) && (u <= ranges->last);
+}
+
+}  // namespace string_view_detail
+
+
+/***
+* @brief A set of characters, built once and queried in constant time.
+* \note  Every character below 256 lives in a 256-bit bitmap, and in the
+*        nibble tables the constructor precomputes for the vectorized
+*        classifier. Wider characters are filtered through a hashed bitmap
+*        and confirmed by a binary search of the sorted ranges they form.
+*        The set owns those ranges: up to 16 are stored inline, a set with
+*        more keeps them all on the heap.
+* @tparam CharT the character type
+****/
+template <typename CharT>
+class basic_char_set final
+{
+
+// Public Member Types
+public:
+    using char_type     = CharT;
+    using size_type     = std::size_t;
+    using const_pointer = typename std::add_pointer<typename std::add_const<CharT>::type>::type;
+
+
+// Constructors
+public:
+    /***
+    * @brief Default constructs an empty basic_char_set
+    ****/
+    constexpr basic_char_set() noexcept = default;
+
+    /***
+    * @brief Constructs a basic_char_set from an ansi string of a given size
+    * @param str the characters in the set
+    * @param count the number of characters
+    ****/
+    constexpr basic_char_set(const_pointer str, size_type count)
+    {
+        for (size_type i = 0UL; i < count; ++i)
+        {
+            this->insert(str[i]);
+        }
+    }
+
+    /***
+    * @brief Constructs a basic_char_set from an ansi-string
+    * @param str the characters in the set
+    ****/
+    constexpr basic_char_set(const_pointer str)
+        : basic_char_set(str, std::char_traits<CharT>::length(str))
+    {
+    }
+
+    /***
+    * @brief Constructs a basic_char_set from the characters of a view
+    * @param str the characters in the set
+    ****/
+    template <typename Traits>
+    constexpr explicit basic_char_set(basic_string_view<CharT, Traits> str)
+        : basic_char_set(str.data(), str.size())
+    {
+    }
+
+
+// Lookup
+public:
+    /***
+    * @brief Checks whether \p c is in the set
+    * @param c the character to check
+    * @return true if \p c is one of the characters of the set
+    ****/
+    constexpr bool contains(CharT c) const noexcept
+    {
+        const auto u = static_cast<unsigned_type>(c);
+
+        if (u < 256U)
+        {
+            return basic_char_set::test(this->m_bits, u);
+        }
+
+        if (!basic_char_set::test(this->m_filter, basic_char_set::hash(u)))
+        {
+            return false;
+        }
+
+        return string_view_detail::in_ranges(this->ranges(), this->m_range_count, u);
+    }
+
+    /***
+    * @brief Checks whether a set of the given characters fits inline
+    * \note  Each character of 256 or more opens at most one range, so a set
+    *        with no more than 16 of them is built without allocating.
+    * @param str the characters in the set
+    * @param count the number of characters
+    * @return true if building the set cannot allocate
+    ****/
+    static constexpr bool fits_inline(const_pointer str, size_type count) noexcept
+    {
+        if constexpr (sizeof(CharT) == 1UL)
+        {
+            return true;
+        }
+
+        size_type wide = 0UL;
+
+        for (size_type i = 0UL; (i < count) && (wide <= inline_ranges); ++i)
+        {
+            wide += (static_cast<unsigned_type>(str[i]) >= 256U) ? 1UL : 0UL;
+        }
+
+        return wide <= inline_ranges;
+    }
+
+    /***
+    * @brief Returns whether the set holds no character at all
+    * @return whether the set is empty
+    ****/
+    constexpr bool empty() const noexcept
+    {
+        return (this->m_bits == bitmap{}) && (this->m_filter == bitmap{});
+    }
+
+
+// Operations
+public:
+    /***
+    * @brief Returns a copy of the set holding both cases of its ASCII letters
+    * \note  What the set stands for under case-insensitive traits.
+    * @return the set, closed under ASCII case folding
+    ****/
+    constexpr basic_char_set with_ascii_case() const
+    {
+        basic_char_set folded(*this);
+
+        for (unsigned lower = 'a'; lower <= 'z'; ++lower)
+        {
+            const unsigned upper = lower - 0x20U;
+            const bool has_lower = basic_char_set::test(this->m_bits, lower);
+
+            if (has_lower != basic_char_set::test(this->m_bits, upper))
+            {
+                folded.insert(static_cast<CharT>(has_lower ? upper : lower));
+            }
+        }
+
+        return folded;
+    }
+
+
+// Private Member
+private:
+    using unsigned_type = std::make_unsigned_t<CharT>;
+    using bitmap        = std::array<std::uint64_t, 4>;
+    using range         = string_view_detail::char_range<unsigned_type>;
+
+    static constexpr size_type inline_ranges = 16UL;
+
+    friend std::size_t string_view_detail::find_in_set(
+        const char *, std::size_t, const basic_char_set<char> &, bool) noexcept;
+    friend std::size_t string_view_detail::rfind_in_set(
+        const char *, std::size_t, const basic_char_set<char> &, bool) noexcept;
+    template <typename T>
+    friend std::size_t string_view_detail::find_in_set(
+        const T *, std::size_t, const basic_char_set<T> &, bool) noexcept;
+    template <typename T>
+    friend std::size_t string_view_detail::rfind_in_set(
+        const T *, std::size_t, const basic_char_set<T> &, bool) noexcept;
+
+    static constexpr bool test(const bitmap &bits, std::size_t i) noexcept
+    {
+        return ((bits[i >> 6U] >> (i & 63U)) & 1U) != 0U;
+    }
+
+    static constexpr void set(bitmap &bits, std::size_t i) noexcept
+    {
+        bits[i >> 6U] |= std::uint64_t(1U) << (i & 63U);
+    }
+
+    static constexpr std::size_t hash(unsigned_type u) noexcept
+    {
+        return string_view_detail::char_set_hash(static_cast<std::uint32_t>(u));
+    }
+
+    /***
+    * @brief Adds \p c to the bitmaps of the set
+    ****/
+    constexpr void insert(CharT c) noexcept
+    {
+        const auto u = static_cast<unsigned_type>(c);
+
+        if (u < 256U)
+        {
+            basic_char_set::set(this->m_bits, u);
+
+            // Nibble tables: one for the low half of the byte range,
+            // one for the high half, indexed by the low nibble and
+            // holding one bit per value of the high nibble.
+            const auto lo = static_cast<unsigned>(u) & 0x0FU;
+            const auto hi = static_cast<unsigned>(u) >> 4U;
+
+            this->m_nibbles[(hi < 8U) ? lo : (lo + 16U)] |=
+                static_cast<std::uint8_t>(1U << (hi & 7U));
+        }
+        else
+        {
+            basic_char_set::set(this->m_filter, basic_char_set::hash(u));
+            this->insert_wide(u);
+        }
+    }
+
+    /***
+    * @brief Returns the sorted, disjoint ranges of the wide members
+    ****/
+    constexpr const range *ranges() const noexcept
+    {
+        return this->m_spilled.empty() ? this->m_inline.data() : this->m_spilled.data();
+    }
+
+    /***
+    * @brief Adds \p u to the ranges, growing or merging them as needed
+    ****/
+    constexpr void insert_wide(unsigned_type u)
+    {
+        range *table = this->m_spilled.empty() ? this->m_inline.data() : this->m_spilled.data();
+
+        // i is the first range starting after u
+        size_type i = 0UL;
+
+        while ((i < this->m_range_count) && (table[i].first <= u))
+        {
+            ++i;
+        }
+
+        if ((i > 0UL) && (u <= table[i - 1UL].last))
+        {
+            return;
+        }
+
+        const bool extends_prev = (i > 0UL) && (table[i - 1UL].last + 1U == u);
+        const bool extends_next = (i < this->m_range_count) && (u + 1U == table[i].first);
+
+        if (extends_prev && extends_next)
+        {
+            table[i - 1UL].last = table[i].last;
+            this->erase_range(table, i);
+        }
+        else if (extends_prev)
+        {
+            table[i - 1UL].last = u;
+        }
+        else if (extends_next)
+        {
+            table[i].first = u;
+        }
+        else
+        {
+            this->insert_range(i, range{u, u});
+        }
+    }
+
+    constexpr void erase_range(range *table, size_type i) noexcept
+    {
+        for (; (i + 1UL) < this->m_range_count; ++i)
+        {
+            table[i] = table[i + 1UL];
+        }
+
+        --this->m_range_count;
+
+        if (!this->m_spilled.empty())
+        {
+            this->m_spilled.pop_back();
+        }
+    }
+
+    constexpr void insert_range(size_type i, range r)
+    {
+        if (!this->m_spilled.empty() || (this->m_range_count == inline_ranges))
+        {
+            if (this->m_spilled.empty())
+            {
+                this->m_spilled.assign(this->m_inline.begin(), this->m_inline.end());
+            }
+
+            this->m_spilled.insert(this->m_spilled.begin() + static_cast<std::ptrdiff_t>(i), r);
+        }
+        else
+        {
+            for (size_type j = this->m_range_count; j > i; --j)
+            {
+                this->m_inline[j] = this->m_inline[j - 1UL];
+            }
+
+            this->m_inline[i] = r;
+        }
+
+        ++this->m_range_count;
+    }
+
+
+private:
+    bitmap m_bits{};                              // members below 256
+    bitmap m_filter{};                            // hashes of the wider members
+    std::array<std::uint8_t, 32> m_nibbles{};     // classifier tables of the members below 256
+    std::array<range, inline_ranges> m_inline{};  // ranges of the wider members
+    std::vector<range> m_spilled;                 // all of them, once they outgrow m_inline
+    size_type m_range_count = 0UL;                // number of ranges
+};
+
+
+// Type Aliases
+
+using char_set    = basic_char_set<char>;
+using wchar_set   = basic_char_set<wchar_t>;
+using u16char_set = basic_char_set<char16_t>;
+using u32char_set = basic_char_set<char32_t>;
+
+#endif
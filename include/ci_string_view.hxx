@@ -0,0 +1,186 @@
+/***********************************************
+** @Copyright (C) 2018 - 2019 Mohammed ELomari.
+** @brief ASCII case-insensitive character traits and views.
+************************************************/
+#ifndef CI_STRING_VIEW_HXX
+#define CI_STRING_VIEW_HXX
+
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+#include "string_view.hxx"
+
+
+namespace string_view_detail
+{
+
+/***
+* @brief Runtime kernels behind ascii_ci_traits, vectorized when the CPU
+*        supports it
+****/
+int ci_compare(const char *a, const char *b, std::size_t n) noexcept;
+
+std::size_t ci_find(const char *s, std::size_t n, char c) noexcept;
+
+std::size_t ci_search(const char *hay, std::size_t n, const char *needle, std::size_t m) noexcept;
+
+std::size_t ci_rsearch(const char *hay, std::size_t n, const char *needle, std::size_t m) noexcept;
+
+}  // namespace string_view_detail
+
+
+/***
+* @brief Character traits comparing ASCII letters regardless of case
+* \note  Only 'A' to 'Z' fold onto 'a' to 'z', every other byte, UTF-8
+*        sequences included, compares as is. Orders like the lower cased
+*        unsigned bytes. Terminating nulls are found by the inherited
+*        length, the C library's strlen.
+****/
+struct ascii_ci_traits : std::char_traits<char>
+{
+    /***
+    * @brief Lower cases an ASCII letter, leaves any other character alone
+    ****/
+    static constexpr char fold(char c) noexcept
+    {
+        return ((c >= 'A') && (c <= 'Z')) ? static_cast<char>(c | 0x20) : c;
+    }
+
+    static constexpr bool eq(char a, char b) noexcept
+    {
+        return fold(a) == fold(b);
+    }
+
+    static constexpr bool lt(char a, char b) noexcept
+    {
+        return static_cast<unsigned char>(fold(a)) < static_cast<unsigned char>(fold(b));
+    }
+
+    static constexpr int compare(const char *a, const char *b, std::size_t n) noexcept
+    {
+        if (!std::is_constant_evaluated())
+        {
+            return string_view_detail::ci_compare(a, b, n);
+        }
+
+        for (std::size_t i = 0UL; i < n; ++i)
+        {
+            if (!eq(a[i], b[i]))
+            {
+                return lt(a[i], b[i]) ? -1 : 1;
+            }
+        }
+
+        return 0;
+    }
+
+    static constexpr const char *find(const char *s, std::size_t n, const char &c) noexcept
+    {
+        if (!std::is_constant_evaluated())
+        {
+            const std::size_t i = string_view_detail::ci_find(s, n, c);
+            return (i == std::size_t(-1L)) ? nullptr : (s + i);
+        }
+
+        for (std::size_t i = 0UL; i < n; ++i)
+        {
+            if (eq(s[i], c))
+            {
+                return s + i;
+            }
+        }
+
+        return nullptr;
+    }
+
+    /***
+    * @brief Substring search hook picked up by basic_string_view::find
+    * @return the position of the first match of \p needle, or npos
+    ****/
+    static std::size_t search(const char *hay, std::size_t n, const char *needle, std::size_t m) noexcept
+    {
+        return string_view_detail::ci_search(hay, n, needle, m);
+    }
+
+    /***
+    * @brief Backward substring search hook picked up by basic_string_view::rfind
+    * @return the position of the last match of \p needle, or npos
+    ****/
+    static std::size_t rsearch(const char *hay, std::size_t n, const char *needle, std::size_t m) noexcept
+    {
+        return string_view_detail::ci_rsearch(hay, n, needle, m);
+    }
+};
+
+
+// Type Aliases
+
+using ci_string_view = basic_string_view<char, ascii_ci_traits>;
+
+
+/***
+* @brief Views the characters of \p str case-insensitively
+****/
+inline constexpr ci_string_view to_ci(string_view str) noexcept
+{
+    return ci_string_view(str.data(), str.size());
+}
+
+
+// Public Functions
+
+/***
+* @brief Tells whether two strings are equal, ignoring ASCII case
+****/
+inline constexpr bool iequals(string_view lhs, string_view rhs) noexcept
+{
+    return to_ci(lhs) == to_ci(rhs);
+}
+
+/***
+* @brief Tells whether \p str starts with \p prefix, ignoring ASCII case
+****/
+inline constexpr bool istarts_with(string_view str, string_view prefix) noexcept
+{
+    return to_ci(str).starts_with(to_ci(prefix));
+}
+
+/***
+* @brief Tells whether \p str ends with \p suffix, ignoring ASCII case
+****/
+inline constexpr bool iends_with(string_view str, string_view suffix) noexcept
+{
+    return to_ci(str).ends_with(to_ci(suffix));
+}
+
+/***
+* @brief Tells whether \p str contains \p needle, ignoring ASCII case
+****/
+inline constexpr bool icontains(string_view str, string_view needle) noexcept
+{
+    return to_ci(str).contains(to_ci(needle));
+}
+
+/***
+* @brief Overload for ostream output of ci_string_view
+* @param o   The output stream to print to
+* @param str the string to print
+* @return reference to the output stream
+****/
+inline auto operator<<(std::basic_ostream<char> &_output, const ci_string_view &_str) -> std::basic_ostream<char> &
+{
+    return _output.write(_str.data(), static_cast<std::streamsize>(_str.size()));
+}
+
+
+/**
+* prevents a completely defined template from being instantiated by compilation units
+* except for our explicit instantiation.
+****/
+
+extern template class basic_string_view<char, ascii_ci_traits>;
+
+#endif
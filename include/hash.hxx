@@ -0,0 +1,234 @@
+/***********************************************
+** @Copyright (C) 2018 - 2019 Mohammed ELomari.
+** @brief Fast hashing of basic_string_view and transparent functors.
+************************************************/
+#ifndef HASH_HXX
+#define HASH_HXX
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+
+#include "string_view.hxx"
+
+
+namespace string_view_detail
+{
+
+/***
+* @brief Inputs from this many bytes on take the striped path of hash_bytes
+****/
+inline constexpr std::size_t hash_long_bytes = 1024UL;
+
+inline constexpr std::uint64_t hash_secret[4] = {
+    0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL, 0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL};
+
+/***
+* @brief Hashes long inputs with the striped accumulator
+* \note  Built in the library, vectorized when the CPU supports it. The
+*        result does not depend on the kernel that ran.
+****/
+std::uint64_t hash_long(const unsigned char *p, std::size_t n, std::uint64_t seed) noexcept;
+
+inline std::uint64_t read8(const unsigned char *p) noexcept
+{
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline std::uint64_t read4(const unsigned char *p) noexcept
+{
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/***
+* @brief Full 64x64 -> 128 bit product, folded back into the two operands
+****/
+inline void multiply(std::uint64_t &a, std::uint64_t &b) noexcept
+{
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 uint128;
+
+    const auto r = static_cast<uint128>(a) * b;
+    a = static_cast<std::uint64_t>(r);
+    b = static_cast<std::uint64_t>(r >> 64U);
+#else
+    const std::uint64_t ha = a >> 32U, hb = b >> 32U;
+    const std::uint64_t la = static_cast<std::uint32_t>(a), lb = static_cast<std::uint32_t>(b);
+    const std::uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    const std::uint64_t t = rl + (rm0 << 32U);
+    const std::uint64_t lo = t + (rm1 << 32U);
+    const std::uint64_t hi = rh + (rm0 >> 32U) + (rm1 >> 32U) + (t < rl) + (lo < t);
+    a = lo;
+    b = hi;
+#endif
+}
+
+inline std::uint64_t mix(std::uint64_t a, std::uint64_t b) noexcept
+{
+    multiply(a, b);
+    return a ^ b;
+}
+
+/***
+* @brief Hashes \p n bytes (wyhash construction for short and medium inputs)
+* @param p    the bytes to hash
+* @param n    the number of bytes
+* @param seed a seed to vary the hash with
+* @return the 64-bit hash
+****/
+inline std::uint64_t hash_bytes(const void *data, std::size_t n, std::uint64_t seed = 0UL) noexcept
+{
+    const auto *p = static_cast<const unsigned char *>(data);
+
+    if (n >= hash_long_bytes)
+    {
+        return hash_long(p, n, seed);
+    }
+
+    seed ^= mix(seed ^ hash_secret[0], hash_secret[1]);
+
+    std::uint64_t a = 0UL;
+    std::uint64_t b = 0UL;
+
+    if (n <= 16UL)
+    {
+        if (n >= 4UL)
+        {
+            const std::size_t shift = (n >> 3U) << 2U;
+            a = (read4(p) << 32U) | read4(p + shift);
+            b = (read4(p + n - 4UL) << 32U) | read4(p + n - 4UL - shift);
+        }
+        else if (n > 0UL)
+        {
+            a = (std::uint64_t(p[0]) << 16U) | (std::uint64_t(p[n >> 1U]) << 8U) | p[n - 1UL];
+        }
+    }
+    else
+    {
+        std::size_t i = n;
+
+        if (i > 48UL)
+        {
+            std::uint64_t see1 = seed;
+            std::uint64_t see2 = seed;
+
+            do
+            {
+                seed = mix(read8(p) ^ hash_secret[1], read8(p + 8) ^ seed);
+                see1 = mix(read8(p + 16) ^ hash_secret[2], read8(p + 24) ^ see1);
+                see2 = mix(read8(p + 32) ^ hash_secret[3], read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48UL;
+            } while (i > 48UL);
+
+            seed ^= see1 ^ see2;
+        }
+
+        while (i > 16UL)
+        {
+            seed = mix(read8(p) ^ hash_secret[1], read8(p + 8) ^ seed);
+            i -= 16UL;
+            p += 16;
+        }
+
+        a = read8(p + i - 16);
+        b = read8(p + i - 8);
+    }
+
+    a ^= hash_secret[1];
+    b ^= seed;
+    multiply(a, b);
+
+    return mix(a ^ hash_secret[0] ^ n, b ^ hash_secret[1]);
+}
+
+}  // namespace string_view_detail
+
+
+/***
+* @brief Hashes the characters of a view
+* @param str the view to hash
+* @param seed a seed to vary the hash with
+* @return the 64-bit hash
+****/
+template <typename CharT>
+inline std::uint64_t hash_value(basic_string_view<CharT> str, std::uint64_t seed = 0UL) noexcept
+{
+    return string_view_detail::hash_bytes(str.data(), str.size() * sizeof(CharT), seed);
+}
+
+
+/***
+* @brief Transparent hash for containers keyed on strings or views
+* \note  Views, std::basic_string and character pointers hash alike, so
+*        an unordered container of std::basic_string can be searched with
+*        a view and no temporary string.
+* @tparam CharT the character type
+****/
+template <typename CharT>
+struct basic_string_view_hash
+{
+    using is_transparent = void;
+
+    std::size_t operator()(basic_string_view<CharT> str) const noexcept
+    {
+        return static_cast<std::size_t>(hash_value(str));
+    }
+
+    template <typename Allocator>
+    std::size_t operator()(const std::basic_string<CharT, std::char_traits<CharT>, Allocator> &str) const noexcept
+    {
+        return (*this)(basic_string_view<CharT>(str));
+    }
+
+    std::size_t operator()(const CharT *str) const noexcept
+    {
+        return (*this)(basic_string_view<CharT>(str));
+    }
+};
+
+/***
+* @brief Transparent equality to go with basic_string_view_hash
+* @tparam CharT the character type
+****/
+template <typename CharT>
+struct basic_string_view_equal
+{
+    using is_transparent = void;
+
+    bool operator()(basic_string_view<CharT> lhs, basic_string_view<CharT> rhs) const noexcept
+    {
+        return lhs == rhs;
+    }
+};
+
+
+// Type Aliases
+
+using string_view_hash    = basic_string_view_hash<char>;
+using wstring_view_hash   = basic_string_view_hash<wchar_t>;
+using u16string_view_hash = basic_string_view_hash<char16_t>;
+using u32string_view_hash = basic_string_view_hash<char32_t>;
+
+using string_view_equal    = basic_string_view_equal<char>;
+using wstring_view_equal   = basic_string_view_equal<wchar_t>;
+using u16string_view_equal = basic_string_view_equal<char16_t>;
+using u32string_view_equal = basic_string_view_equal<char32_t>;
+
+
+/***
+* @brief std::hash for views with the default traits
+****/
+template <typename CharT>
+struct std::hash<basic_string_view<CharT>> : basic_string_view_hash<CharT>
+{
+};
+
+#endif
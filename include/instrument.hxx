@@ -0,0 +1,213 @@
+/***********************************************
+** @Copyright (C) 2018 - 2019 Mohammed ELomari.
+** @brief Opt-in counters and timers in the hot members of basic_string_view.
+** \note  Off unless STRING_VIEW_INSTRUMENT is defined, in which case the
+**        probes below count every call, the bytes it was handed and, for
+**        find and rfind on substrings, the candidate positions checked
+**        against the whole needle. The case-insensitive searches, the
+**        single character find and the other members report no
+**        verifications. Defining
+**        STRING_VIEW_INSTRUMENT_TIMERS as well times the calls with the
+**        steady clock. Both must be the same for the library and every
+**        translation unit using it: set them through the CMake options
+**        of the same names, which export them with the target.
+************************************************/
+#ifndef STRING_VIEW_INSTRUMENT_HXX
+#define STRING_VIEW_INSTRUMENT_HXX
+
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+
+/***
+* @brief The members of basic_string_view that carry a probe
+* \note  The char, pointer and count overloads of a member are counted
+*        under the view overload they forward to.
+****/
+enum class instrumented_member : unsigned
+{
+    find,
+    rfind,
+    find_first_of,
+    find_last_of,
+    find_first_not_of,
+    find_last_not_of,
+    compare,
+    equal
+};
+
+inline constexpr std::size_t instrumented_member_count = 8UL;
+
+/***
+* @brief What the probes of one member have seen so far
+* \note  Updated with relaxed atomics, so the numbers are exact once the
+*        threads calling the member are done, and only approximate while
+*        they run.
+****/
+struct instrument_counters
+{
+    std::atomic<std::uint64_t> calls{0UL};          // times the member was called
+    std::atomic<std::uint64_t> bytes{0UL};          // bytes the calls were asked to look at
+    std::atomic<std::uint64_t> verifications{0UL};  // candidates compared to the whole needle
+    std::atomic<std::uint64_t> nanoseconds{0UL};    // time spent, with STRING_VIEW_INSTRUMENT_TIMERS
+};
+
+
+namespace string_view_detail
+{
+
+inline instrument_counters instrument_table[instrumented_member_count];
+
+}  // namespace string_view_detail
+
+
+/***
+* @brief Returns the counters of one member, shared by all the character types
+****/
+inline instrument_counters &instrument_counters_of(instrumented_member member) noexcept
+{
+    return string_view_detail::instrument_table[static_cast<std::size_t>(member)];
+}
+
+/***
+* @brief Returns the name of a member, as spelled in basic_string_view
+****/
+inline constexpr const char *instrument_name(instrumented_member member) noexcept
+{
+    constexpr const char *names[instrumented_member_count] = {
+        "find", "rfind", "find_first_of", "find_last_of",
+        "find_first_not_of", "find_last_not_of", "compare", "operator=="};
+
+    return names[static_cast<std::size_t>(member)];
+}
+
+/***
+* @brief Sets every counter back to zero
+****/
+inline void instrument_reset() noexcept
+{
+    for (instrument_counters &counters : string_view_detail::instrument_table)
+    {
+        counters.calls.store(0UL, std::memory_order_relaxed);
+        counters.bytes.store(0UL, std::memory_order_relaxed);
+        counters.verifications.store(0UL, std::memory_order_relaxed);
+        counters.nanoseconds.store(0UL, std::memory_order_relaxed);
+    }
+}
+
+
+namespace string_view_detail
+{
+
+/***
+* @brief Adds \p count verifications to the counters of \p member
+* \note  For the vectorized kernels, which run outside the probes.
+****/
+inline void instrument_verified(instrumented_member member, std::size_t count) noexcept
+{
+    instrument_counters_of(member).verifications.fetch_add(count, std::memory_order_relaxed);
+}
+
+/***
+* @brief Counts one call of a member for as long as it lives
+* \note  Does nothing during constant evaluation.
+****/
+class instrument_probe final
+{
+
+// Constructors
+public:
+    constexpr explicit instrument_probe(instrumented_member member) noexcept
+        : m_counters(nullptr)
+        , m_verifications(0UL)
+        , m_start(0L)
+    {
+        if (!std::is_constant_evaluated())
+        {
+            this->m_counters = &instrument_counters_of(member);
+            this->m_counters->calls.fetch_add(1UL, std::memory_order_relaxed);
+#if defined(STRING_VIEW_INSTRUMENT_TIMERS)
+            this->m_start = std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+        }
+    }
+
+    instrument_probe(const instrument_probe &) = delete;
+    instrument_probe &operator=(const instrument_probe &) = delete;
+
+    constexpr ~instrument_probe()
+    {
+        if ((this->m_counters != nullptr) && (this->m_verifications != 0UL))
+        {
+            this->m_counters->verifications.fetch_add(this->m_verifications, std::memory_order_relaxed);
+        }
+
+#if defined(STRING_VIEW_INSTRUMENT_TIMERS)
+        if (this->m_counters != nullptr)
+        {
+            const auto elapsed = std::chrono::steady_clock::duration(
+                std::chrono::steady_clock::now().time_since_epoch().count() - this->m_start);
+
+            this->m_counters->nanoseconds.fetch_add(
+                static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+                std::memory_order_relaxed);
+        }
+#endif
+    }
+
+
+// Operations
+public:
+    /***
+    * @brief Records that the call got to look at \p bytes bytes
+    ****/
+    constexpr void scan(std::size_t bytes) noexcept
+    {
+        if (this->m_counters != nullptr)
+        {
+            this->m_counters->bytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+    }
+
+    /***
+    * @brief Records \p count candidates checked against the whole needle
+    * \note  Summed locally and added to the counters once, when the call ends.
+    ****/
+    constexpr void verify(std::size_t count) noexcept
+    {
+        this->m_verifications += count;
+    }
+
+
+private:
+    instrument_counters *m_counters;          // null during constant evaluation
+    std::size_t m_verifications;             // verifications of this call so far
+    std::chrono::steady_clock::rep m_start;  // clock ticks when the call started
+};
+
+}  // namespace string_view_detail
+
+
+/**
+* Probes placed in the members: STRING_VIEW_PROBE opens the count of a
+* call, STRING_VIEW_SCAN records the bytes it goes on to look at and
+* STRING_VIEW_VERIFY the candidates it checks. STRING_VIEW_VERIFIED is
+* for the search kernels of the library, which have no probe in scope.
+****/
+#if defined(STRING_VIEW_INSTRUMENT)
+#define STRING_VIEW_PROBE(member) string_view_detail::instrument_probe string_view_probe_(member)
+#define STRING_VIEW_SCAN(bytes) string_view_probe_.scan(bytes)
+#define STRING_VIEW_VERIFY(count) string_view_probe_.verify(count)
+#define STRING_VIEW_VERIFIED(member, count) string_view_detail::instrument_verified(instrumented_member::member, count)
+#else
+#define STRING_VIEW_PROBE(member) static_cast<void>(0)
+#define STRING_VIEW_SCAN(bytes) static_cast<void>(0)
+#define STRING_VIEW_VERIFY(count) static_cast<void>(0)
+#define STRING_VIEW_VERIFIED(member, count) static_cast<void>(0)
+#endif
+
+#endif
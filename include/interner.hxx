@@ -0,0 +1,300 @@
+/***********************************************
+** @Copyright (C) 2018 - 2019 Mohammed ELomari.
+** @brief Deduplicates strings into an arena and hands out stable views.
+************************************************/
+#ifndef INTERNER_HXX
+#define INTERNER_HXX
+
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "hash.hxx"
+#include "string_view.hxx"
+
+
+/***
+* @brief A pool of unique strings
+* \note  Each distinct string is copied once, null terminated, into large
+*        blocks carved with a bump pointer. The views handed out stay
+*        valid until the interner is cleared or destroyed, and two views
+*        returned for equal strings share the same data(), so interned
+*        views compare equal in O(1) with basic_interner::same.
+*        Not thread safe.
+* @tparam CharT the character type
+****/
+template <typename CharT>
+class basic_interner final
+{
+
+// Public Member Types
+public:
+    using char_type = CharT;
+    using size_type = std::size_t;
+    using view_type = basic_string_view<CharT>;
+
+
+// Constructors
+public:
+    /***
+    * @brief Constructs an empty interner
+    * @param block_size the number of characters carved per arena block
+    ****/
+    explicit basic_interner(size_type block_size = (64UL * 1024UL) / sizeof(CharT))
+        : m_block_size(std::max<size_type>(block_size, 1UL))
+    {
+    }
+
+    basic_interner(const basic_interner &) = delete;
+
+    /***
+    * @brief Takes over the strings and the arena of \p other
+    * \note  Views handed out by \p other stay valid. \p other is left
+    *        empty, with no block to carve from, and may be reused.
+    ****/
+    basic_interner(basic_interner &&other) noexcept
+        : m_slots(std::move(other.m_slots))
+        , m_count(std::exchange(other.m_count, 0UL))
+        , m_blocks(std::move(other.m_blocks))
+        , m_cursor(std::exchange(other.m_cursor, nullptr))
+        , m_left(std::exchange(other.m_left, 0UL))
+        , m_reserved(std::exchange(other.m_reserved, 0UL))
+        , m_block_size(other.m_block_size)
+    {
+        other.m_slots.clear();
+        other.m_blocks.clear();
+    }
+
+
+// Assignment
+public:
+    basic_interner &operator=(const basic_interner &) = delete;
+
+    /***
+    * @brief Releases the arena, then takes over the one of \p other
+    * \note  Invalidates the views handed out by this interner, not the
+    *        ones handed out by \p other, which is left empty.
+    ****/
+    basic_interner &operator=(basic_interner &&other) noexcept
+    {
+        if (this != &other)
+        {
+            this->m_slots      = std::move(other.m_slots);
+            this->m_count      = std::exchange(other.m_count, 0UL);
+            this->m_blocks     = std::move(other.m_blocks);
+            this->m_cursor     = std::exchange(other.m_cursor, nullptr);
+            this->m_left       = std::exchange(other.m_left, 0UL);
+            this->m_reserved   = std::exchange(other.m_reserved, 0UL);
+            this->m_block_size = other.m_block_size;
+
+            other.m_slots.clear();
+            other.m_blocks.clear();
+        }
+
+        return *this;
+    }
+
+
+// Capacity
+public:
+    /***
+    * @brief Returns the number of distinct strings held
+    ****/
+    size_type size() const noexcept { return this->m_count; }
+
+    /***
+    * @brief Returns whether no string is held
+    ****/
+    bool empty() const noexcept { return this->m_count == 0UL; }
+
+    /***
+    * @brief Returns the number of bytes reserved by the arena and the index
+    ****/
+    size_type memory() const noexcept
+    {
+        return (this->m_reserved * sizeof(CharT)) + (this->m_slots.capacity() * sizeof(slot));
+    }
+
+
+// Operations
+public:
+    /***
+    * @brief Returns the interned copy of \p str, adding it if needed
+    * @param str the string to intern
+    * @return a stable view on the interned copy
+    ****/
+    view_type intern(view_type str)
+    {
+        const std::uint64_t hash = hash_value(str);
+
+        if (((this->m_count + 1UL) * 4UL) > (this->m_slots.size() * 3UL))
+        {
+            this->rehash(std::max<size_type>(this->m_slots.size() * 2UL, 64UL));
+        }
+
+        slot &s = this->probe(str, hash);
+
+        if (s.data == nullptr)
+        {
+            CharT *copy = this->allocate(str.size() + 1UL);
+
+            std::copy(str.begin(), str.end(), copy);
+            copy[str.size()] = CharT();
+
+            s = slot{hash, copy, str.size()};
+            ++this->m_count;
+        }
+
+        return view_type(s.data, s.size);
+    }
+
+    /***
+    * @brief Looks \p str up without adding it
+    * @param str the string to look for
+    * @return the interned copy, or an empty view with a null data()
+    ****/
+    view_type find(view_type str) const noexcept
+    {
+        if (this->m_slots.empty())
+        {
+            return view_type();
+        }
+
+        const slot &s = const_cast<basic_interner *>(this)->probe(str, hash_value(str));
+
+        return view_type(s.data, s.size);
+    }
+
+    /***
+    * @brief Compares two views returned by the same interner
+    * @return whether they refer to the same string
+    ****/
+    static constexpr bool same(view_type lhs, view_type rhs) noexcept
+    {
+        return (lhs.data() == rhs.data()) && (lhs.size() == rhs.size());
+    }
+
+    /***
+    * @brief Forgets every string and releases the arena
+    * \note  Invalidates every view handed out so far.
+    ****/
+    void clear() noexcept
+    {
+        this->m_slots.clear();
+        this->m_blocks.clear();
+        this->m_count    = 0UL;
+        this->m_cursor   = nullptr;
+        this->m_left     = 0UL;
+        this->m_reserved = 0UL;
+    }
+
+
+// Private Member
+private:
+    struct slot
+    {
+        std::uint64_t hash;
+        const CharT *data;  // null for a free slot
+        size_type size;
+    };
+
+    /***
+    * @brief Finds the slot holding \p str, or the free slot where it goes
+    * \note  Open addressing with linear probing over a power-of-two table.
+    ****/
+    slot &probe(view_type str, std::uint64_t hash) noexcept
+    {
+        const size_type mask = this->m_slots.size() - 1UL;
+
+        for (size_type i = static_cast<size_type>(hash) & mask;; i = (i + 1UL) & mask)
+        {
+            slot &s = this->m_slots[i];
+
+            if ((s.data == nullptr) ||
+                ((s.hash == hash) && (view_type(s.data, s.size) == str)))
+            {
+                return s;
+            }
+        }
+    }
+
+    void rehash(size_type capacity)
+    {
+        std::vector<slot> old(capacity, slot{0UL, nullptr, 0UL});
+        old.swap(this->m_slots);
+
+        for (const slot &s : old)
+        {
+            if (s.data != nullptr)
+            {
+                this->probe(view_type(s.data, s.size), s.hash) = s;
+            }
+        }
+    }
+
+    /***
+    * @brief Carves \p n characters off the current arena block
+    ****/
+    CharT *allocate(size_type n)
+    {
+        if (n > this->m_left)
+        {
+            // Strings larger than a block get a block of their own
+            const size_type size = std::max(n, this->m_block_size);
+
+            this->m_blocks.push_back(std::make_unique_for_overwrite<CharT[]>(size));
+            this->m_reserved += size;
+
+            if (size > this->m_block_size)
+            {
+                return this->m_blocks.back().get();
+            }
+
+            this->m_cursor = this->m_blocks.back().get();
+            this->m_left   = size;
+        }
+
+        CharT *p = this->m_cursor;
+
+        this->m_cursor += n;
+        this->m_left -= n;
+
+        return p;
+    }
+
+
+private:
+    std::vector<slot> m_slots;                      // the index, power-of-two sized
+    size_type m_count = 0UL;                        // occupied slots
+    std::vector<std::unique_ptr<CharT[]>> m_blocks;  // the arena
+    CharT *m_cursor = nullptr;                      // next free character of the current block
+    size_type m_left = 0UL;                         // free characters left in the current block
+    size_type m_reserved = 0UL;                     // characters allocated over all blocks
+    size_type m_block_size;                         // characters per regular block
+};
+
+
+// Type Aliases
+
+using interner    = basic_interner<char>;
+using winterner   = basic_interner<wchar_t>;
+using u16interner = basic_interner<char16_t>;
+using u32interner = basic_interner<char32_t>;
+
+
+/**
+* prevents a completely defined template from being instantiated by compilation units
+* except for our explicit instantiation.
+****/
+
+extern template class basic_interner<char>;
+extern template class basic_interner<wchar_t>;
+extern template class basic_interner<char16_t>;
+extern template class basic_interner<char32_t>;
+
+#endif
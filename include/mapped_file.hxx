@@ -0,0 +1,268 @@
+/***********************************************
+** @Copyright (C) 2018 - 2019 Mohammed ELomari.
+** @brief Read-only memory mapped files, viewed as string_view.
+************************************************/
+#ifndef MAPPED_FILE_HXX
+#define MAPPED_FILE_HXX
+
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+
+#include "split.hxx"
+#include "string_view.hxx"
+
+
+/***
+* @brief How a mapping is going to be read, passed on to the kernel
+****/
+enum class access_pattern
+{
+    normal,      // no particular order
+    sequential,  // front to back, read ahead aggressively
+    random       // no read ahead
+};
+
+
+/***
+* @brief A read-only mapping of a whole file or of a window of it
+* \note  The characters are never copied: view() hands out a string_view
+*        over the pages of the file. Views are invalidated when the
+*        mapping is moved away, remapped or destroyed.
+*        System errors are reported as std::system_error.
+****/
+class mapped_file final
+{
+
+// Public Member Types
+public:
+    using size_type = std::size_t;
+
+
+// Constructors
+public:
+    /***
+    * @brief Default constructs a mapped_file without any file
+    ****/
+    mapped_file() noexcept = default;
+
+    /***
+    * @brief Maps a whole file
+    * @param path    the file to map
+    * @param pattern how the mapping is going to be read
+    ****/
+    explicit mapped_file(const std::string &path, access_pattern pattern = access_pattern::normal);
+
+    /***
+    * @brief Maps a window of a file
+    * \note  The window is clamped to the end of the file.
+    * @param path    the file to map
+    * @param offset  the position of the window in the file
+    * @param length  the size of the window
+    * @param pattern how the mapping is going to be read
+    ****/
+    mapped_file(const std::string &path, std::uint64_t offset, size_type length,
+                access_pattern pattern = access_pattern::normal);
+
+    mapped_file(const mapped_file &) = delete;
+
+    /***
+    * @brief Takes over the mapping of another mapped_file
+    * @param other the mapped_file being moved
+    ****/
+    mapped_file(mapped_file &&other) noexcept;
+
+    ~mapped_file();
+
+
+// Assignment
+public:
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    /***
+    * @brief Releases the current mapping and takes over another one
+    * @param other the mapped_file being moved
+    * @return reference to \c (*this)
+    ****/
+    mapped_file &operator=(mapped_file &&other) noexcept;
+
+
+// Capacity
+public:
+    /***
+    * @brief Returns the size of the mapped window
+    ****/
+    size_type size() const noexcept { return this->m_size; }
+
+    /***
+    * @brief Returns whether nothing is mapped
+    ****/
+    bool empty() const noexcept { return this->m_size == 0UL; }
+
+    /***
+    * @brief Returns the position of the mapped window in the file
+    ****/
+    std::uint64_t offset() const noexcept { return this->m_offset; }
+
+    /***
+    * @brief Returns the size of the whole file
+    ****/
+    std::uint64_t file_size() const noexcept { return this->m_file_size; }
+
+
+// Element Access
+public:
+    /***
+    * @brief Gets the first mapped character
+    ****/
+    const char *data() const noexcept { return this->m_data; }
+
+    /***
+    * @brief Gets a view over the mapped window
+    ****/
+    string_view view() const noexcept { return string_view(this->m_data, this->m_size); }
+
+
+// Modifiers
+public:
+    /***
+    * @brief Maps another window of the same file in place of the current one
+    * \note  The window is clamped to the end of the file. The access
+    *        pattern given at construction is applied to the new mapping,
+    *        and ignored if the kernel turns it down.
+    * @param offset the position of the window in the file
+    * @param length the size of the window
+    ****/
+    void remap(std::uint64_t offset, size_type length);
+
+    /***
+    * @brief Tells the kernel how the mapping is going to be read
+    * @param pattern how the mapping is going to be read
+    ****/
+    void advise(access_pattern pattern) const;
+
+    /***
+    * @brief Asks the kernel to back the mapping with huge pages
+    * \note  Only honoured by kernels that support transparent huge pages
+    *        for file mappings.
+    * @return whether the kernel accepted the request
+    ****/
+    bool advise_huge_pages() const noexcept;
+
+
+// Iteration
+public:
+    /***
+    * @brief Iterates the lines of the mapped window
+    ****/
+    auto lines() const noexcept { return ::lines(this->view()); }
+
+    /***
+    * @brief Iterates the fields of the mapped window
+    * @param delimiter the character between two fields
+    ****/
+    auto split(char delimiter) const noexcept { return ::split(this->view(), delimiter); }
+
+
+// Private Member
+private:
+    void unmap() noexcept;
+
+
+private:
+    int m_fd = -1;                      // the open file
+    std::uint64_t m_file_size = 0UL;    // the size of the whole file
+    std::uint64_t m_offset = 0UL;       // position of the window in the file
+    void *m_base = nullptr;             // start of the mapping, page aligned
+    size_type m_length = 0UL;           // length of the mapping
+    const char *m_data = nullptr;       // first character of the window
+    size_type m_size = 0UL;             // size of the window
+    access_pattern m_pattern = access_pattern::normal;  // advice replayed on remap
+};
+
+
+/***
+* @brief Walks a file one mapped window at a time
+* \note  Only one window is mapped at any time, so the address space used
+*        stays bounded whatever the size of the file. Each window is cut
+*        right after its last \p boundary character, so records never
+*        straddle two windows unless one is longer than a window.
+*        This is a single-pass range: moving to the next window unmaps the
+*        previous one.
+****/
+class mapped_windows final
+{
+
+// Public Member Types
+public:
+    using size_type = std::size_t;
+
+    class iterator
+    {
+    public:
+        using value_type       = string_view;
+        using difference_type  = std::ptrdiff_t;
+        using iterator_concept = std::input_iterator_tag;
+
+        iterator() noexcept = default;
+        explicit iterator(mapped_windows *windows) noexcept : m_windows(windows) {}
+
+        string_view operator*() const noexcept { return this->m_windows->m_current; }
+
+        iterator &operator++()
+        {
+            this->m_windows->advance();
+            return *this;
+        }
+
+        void operator++(int) { ++(*this); }
+
+        bool operator==(std::default_sentinel_t) const noexcept
+        {
+            return (this->m_windows == nullptr) || this->m_windows->m_done;
+        }
+
+    private:
+        mapped_windows *m_windows = nullptr;
+    };
+
+
+// Constructors
+public:
+    /***
+    * @brief Opens a file to walk it window by window
+    * @param path        the file to map
+    * @param window_size the largest window to map at once
+    * @param boundary    the character that ends a record
+    ****/
+    mapped_windows(const std::string &path, size_type window_size, char boundary = '\n');
+
+
+// Iterators
+public:
+    /***
+    * @brief Maps the first window
+    ****/
+    iterator begin();
+
+    std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+
+
+// Private Member
+private:
+    void load(std::uint64_t offset);
+
+    void advance();
+
+
+private:
+    mapped_file m_file;          // the current window
+    size_type m_window_size;     // the largest window to map
+    char m_boundary;             // the character that ends a record
+    string_view m_current;       // the current window, cut after the last boundary
+    bool m_done = false;         // whether the end of the file was reached
+};
+
+#endif
@@ -0,0 +1,568 @@
+/***********************************************
+** @Copyright (C) 2018 - 2019 Mohammed ELomari.
+** @brief Searches a view for many needles in a single pass.
+************************************************/
+#ifndef MULTI_SEARCHER_HXX
+#define MULTI_SEARCHER_HXX
+
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "string_view.hxx"
+
+
+namespace string_view_detail
+{
+
+/***
+* @brief Needle sets up to this size are scanned with the fingerprint
+*        prefilter, when the CPU supports AVX2.
+****/
+inline constexpr std::size_t teddy_max_patterns = 32UL;
+
+/***
+* @brief Needle prefixes up to this length feed the fingerprint
+****/
+inline constexpr std::size_t teddy_max_width = 3UL;
+
+/***
+* @brief Tells whether the fingerprint prefilter may be used on this CPU
+* \note  It needs a byte shuffle as wide as AVX2's to pay off, so without
+*        it every needle set runs through the automaton.
+****/
+bool teddy_supported() noexcept;
+
+/***
+* @brief Finds the next position whose fingerprint matches one of the buckets
+* \note  Only valid once teddy_supported() returned true.
+* @param s       the characters to scan
+* @param n       number of characters in \p s, at least \p width
+* @param from    the first candidate position
+* @param masks   the nibble tables, 32 bytes per fingerprinted character
+* @param width   how many leading characters of each needle are fingerprinted
+* @param buckets receives one bit per bucket that may match at the position
+* @return the candidate position, or npos
+****/
+std::size_t teddy_next(const char *s, std::size_t n, std::size_t from,
+                       const std::uint8_t *masks, std::size_t width,
+                       std::uint8_t &buckets) noexcept;
+
+}  // namespace string_view_detail
+
+
+/***
+* @brief Finds occurrences of a fixed set of needles in one pass
+* \note  Small sets of \c char needles are located with a vectorized
+*        fingerprint of their first characters (Teddy) and then verified,
+*        on CPUs with AVX2. Anything else runs through an Aho-Corasick
+*        automaton whose transitions live in one flat table over a
+*        compressed alphabet. Empty needles never match.
+* @tparam CharT the character type
+* @tparam Traits the character traits
+****/
+template <typename CharT, typename Traits = std::char_traits<CharT>>
+class multi_searcher final
+{
+
+// Public Member Types
+public:
+    using char_type = CharT;
+    using size_type = std::size_t;
+    using view_type = basic_string_view<CharT, Traits>;
+
+    /***
+    * @brief One occurrence of a needle
+    ****/
+    struct match
+    {
+        size_type pattern;  // index of the needle in the construction list
+        size_type offset;   // position of the occurrence in the haystack
+
+        friend constexpr bool operator==(const match &, const match &) noexcept = default;
+    };
+
+// Public Members
+public:
+    static constexpr size_type npos = view_type::npos;
+
+
+// Constructors
+public:
+    /***
+    * @brief Default constructs a multi_searcher without any needle
+    ****/
+    multi_searcher() : multi_searcher(std::initializer_list<view_type>{}) {}
+
+    /***
+    * @brief Builds the searcher for a list of needles
+    * @param needles the needles to look for
+    ****/
+    multi_searcher(std::initializer_list<view_type> needles)
+        : multi_searcher(std::ranges::subrange(needles.begin(), needles.end()))
+    {
+    }
+
+    /***
+    * @brief Builds the searcher for a range of needles
+    * \note  The needles are copied, the range may go away afterwards.
+    * @param needles the needles to look for
+    ****/
+    template <std::ranges::input_range Range>
+        requires std::is_convertible_v<std::ranges::range_reference_t<Range>, view_type>
+    explicit multi_searcher(Range &&needles)
+    {
+        for (view_type needle : needles)
+        {
+            this->m_offsets.push_back(this->m_chars.size());
+            this->m_chars.insert(this->m_chars.end(), needle.begin(), needle.end());
+        }
+
+        this->m_offsets.push_back(this->m_chars.size());
+
+        if (!this->build_teddy())
+        {
+            this->build_automaton();
+        }
+    }
+
+
+// Capacity
+public:
+    /***
+    * @brief Returns the number of needles
+    * @return the number of needles
+    ****/
+    size_type size() const noexcept { return this->m_offsets.size() - 1UL; }
+
+    /***
+    * @brief Returns the needle with index \p pattern
+    * @param pattern the index of the needle
+    * @return a view on the copy of the needle held by the searcher
+    ****/
+    view_type pattern(size_type pattern) const noexcept
+    {
+        return view_type(( this->m_chars.data() + this->m_offsets[pattern] ),
+                         ( this->m_offsets[pattern + 1UL] - this->m_offsets[pattern] ));
+    }
+
+
+// SEARCH
+public:
+    /**
+    * @brief find the leftmost occurrence of any needle.
+    * \note  Ties between needles starting at the same position go to the
+    *        one listed first.
+    * @return the match, or {npos, npos} when no needle occurs
+    ***/
+    match find(view_type haystack, size_type pos = 0UL) const noexcept
+    {
+        match best{npos, npos};
+
+        this->scan(haystack, pos, [&best](const match &m) {
+            if ((m.offset < best.offset) || ((m.offset == best.offset) && (m.pattern < best.pattern)))
+            {
+                best = m;
+            }
+        }, true);
+
+        return best;
+    }
+
+    /**
+    * @brief find every occurrence of every needle, overlapping ones included.
+    * \note  The order of the reported matches is unspecified.
+    * @param haystack the characters to search in
+    * @param out      receives one match per occurrence
+    * @return the output iterator past the last match written
+    ***/
+    template <std::output_iterator<match> OutputIt>
+    OutputIt find_all(view_type haystack, OutputIt out) const
+    {
+        this->scan(haystack, 0UL, [&out](const match &m) { *out++ = m; }, false);
+        return out;
+    }
+
+    /**
+    * @brief count the occurrences of all needles, overlapping ones included.
+    ***/
+    size_type count(view_type haystack) const noexcept
+    {
+        size_type total = 0UL;
+        this->scan(haystack, 0UL, [&total](const match &) { ++total; }, false);
+        return total;
+    }
+
+
+// Private Member
+private:
+    using state_type = std::uint32_t;
+    using wide_class = std::pair<CharT, state_type>;
+
+    static constexpr state_type no_state = state_type(-1);
+    static constexpr bool plain_traits   = std::is_same_v<Traits, std::char_traits<CharT>>;
+
+    /***
+    * @brief Runs the selected engine over \p haystack
+    * @param haystack the characters to search in
+    * @param pos      the position to start at
+    * @param report   called with each match found
+    * @param leftmost whether to stop as soon as no earlier match can follow
+    ****/
+    template <typename Report>
+    void scan(view_type haystack, size_type pos, Report &&report, bool leftmost) const
+    {
+        if (pos >= haystack.size())
+        {
+            return;
+        }
+
+        if (this->m_teddy_width != 0UL)
+        {
+            this->scan_teddy(haystack, pos, report, leftmost);
+        }
+        else
+        {
+            this->scan_automaton(haystack, pos, report, leftmost);
+        }
+    }
+
+    template <typename Report>
+    void scan_teddy(view_type haystack, size_type pos, Report &report, bool leftmost) const
+    {
+        if constexpr (std::is_same_v<CharT, char>)
+        {
+            const size_type n = haystack.size();
+
+            if (n < this->m_teddy_width)
+            {
+                return;
+            }
+
+            std::uint8_t buckets = 0U;
+
+            while ((pos = string_view_detail::teddy_next(haystack.data(), n, pos, this->m_teddy_masks.data(),
+                                                         this->m_teddy_width, buckets)) != npos)
+            {
+                for (size_type id = 0UL; id < this->size(); ++id)
+                {
+                    if (((buckets >> (id % 8UL)) & 1U) == 0U)
+                    {
+                        continue;
+                    }
+
+                    const view_type needle = this->pattern(id);
+
+                    if ((needle.size() <= (n - pos)) &&
+                        (Traits::compare(( haystack.data() + pos ), needle.data(), needle.size()) == 0))
+                    {
+                        report(match{id, pos});
+
+                        // Needles are tried in order, so this one wins the tie
+                        if (leftmost)
+                        {
+                            return;
+                        }
+                    }
+                }
+
+                ++pos;
+            }
+        }
+    }
+
+    template <typename Report>
+    void scan_automaton(view_type haystack, size_type pos, Report &report, bool leftmost) const
+    {
+        size_type best_start = npos;
+        state_type state     = 0U;
+
+        for (size_type i = pos; i < haystack.size(); ++i)
+        {
+            state = this->m_next[(state * this->m_classes) + this->class_of(haystack[i])];
+
+            if (leftmost && (best_start != npos) && ((i + 1UL - this->m_depth[state]) > best_start))
+            {
+                return;
+            }
+
+            for (state_type out = this->m_output[state]; out != no_state; out = this->m_output_link[out])
+            {
+                for (state_type id = this->m_state_pattern[out]; id != no_state; id = this->m_same_pattern[id])
+                {
+                    const size_type start = i + 1UL - this->pattern(id).size();
+
+                    best_start = std::min(best_start, start);
+                    report(match{id, start});
+                }
+            }
+        }
+    }
+
+    /***
+    * @brief Maps a haystack character to its class in the compressed alphabet
+    * \note  Class 0 holds every character that occurs in no needle.
+    ****/
+    state_type class_of(CharT c) const noexcept
+    {
+        const auto u = static_cast<std::make_unsigned_t<CharT>>(c);
+
+        if (u < 256U)
+        {
+            return this->m_byte_class[u];
+        }
+
+        if constexpr (plain_traits)
+        {
+            const auto it = std::ranges::lower_bound(this->m_wide_class, c, {}, &wide_class::first);
+
+            if ((it != this->m_wide_class.end()) && (it->first == c))
+            {
+                return it->second;
+            }
+        }
+        else
+        {
+            for (const auto &[chr, cls] : this->m_wide_class)
+            {
+                if (Traits::eq(chr, c))
+                {
+                    return cls;
+                }
+            }
+        }
+
+        return 0U;
+    }
+
+    /***
+    * @brief Prepares the fingerprint prefilter, when it applies
+    * \note  Needle i goes to bucket i % 8. For each fingerprinted
+    *        position, two 16-entry tables keyed by the low and the high
+    *        nibble of the character hold the buckets it may belong to.
+    * @return whether the prefilter will be used
+    ****/
+    bool build_teddy()
+    {
+        if constexpr (std::is_same_v<CharT, char> && plain_traits)
+        {
+            if ((this->size() == 0UL) || (this->size() > string_view_detail::teddy_max_patterns) ||
+                !string_view_detail::teddy_supported())
+            {
+                return false;
+            }
+
+            size_type width = string_view_detail::teddy_max_width;
+
+            for (size_type id = 0UL; id < this->size(); ++id)
+            {
+                width = std::min(width, this->pattern(id).size());
+            }
+
+            if (width == 0UL)
+            {
+                return false;
+            }
+
+            for (size_type id = 0UL; id < this->size(); ++id)
+            {
+                const auto bucket = static_cast<std::uint8_t>(1U << (id % 8UL));
+                const view_type needle = this->pattern(id);
+
+                for (size_type j = 0UL; j < width; ++j)
+                {
+                    const auto u = static_cast<unsigned char>(needle[j]);
+
+                    this->m_teddy_masks[(32UL * j) + (u & 0x0FU)] |= bucket;
+                    this->m_teddy_masks[(32UL * j) + 16UL + (u >> 4U)] |= bucket;
+                }
+            }
+
+            this->m_teddy_width = width;
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    /***
+    * @brief Builds the Aho-Corasick automaton as a complete flat DFA
+    ****/
+    void build_automaton()
+    {
+        // Compressed alphabet: one class per distinct needle character
+        this->m_classes = 1UL;
+
+        for (const CharT c : this->m_chars)
+        {
+            if (this->class_of(c) != 0U)
+            {
+                continue;
+            }
+
+            const auto u  = static_cast<std::make_unsigned_t<CharT>>(c);
+            const auto id = static_cast<state_type>(this->m_classes++);
+
+            if constexpr (plain_traits)
+            {
+                if (u < 256U)
+                {
+                    this->m_byte_class[u] = id;
+                }
+            }
+            else
+            {
+                // Every character the traits consider equal shares the class
+                for (std::size_t b = 0UL; b < 256UL; ++b)
+                {
+                    if (Traits::eq(static_cast<CharT>(b), c))
+                    {
+                        this->m_byte_class[b] = id;
+                    }
+                }
+            }
+
+            if (u >= 256U)
+            {
+                // Kept sorted so lookups can bisect
+                const auto it = std::ranges::upper_bound(this->m_wide_class, c, {}, &wide_class::first);
+                this->m_wide_class.emplace(it, c, id);
+            }
+        }
+
+        // Trie
+        this->m_same_pattern.assign(this->size(), no_state);
+        this->add_state(0U);
+
+        for (size_type id = 0UL; id < this->size(); ++id)
+        {
+            const view_type needle = this->pattern(id);
+
+            if (needle.empty())
+            {
+                continue;
+            }
+
+            state_type state = 0U;
+
+            for (const CharT c : needle)
+            {
+                const size_type slot = (state * this->m_classes) + this->class_of(c);
+
+                if (this->m_next[slot] == no_state)
+                {
+                    this->m_next[slot] = this->add_state(this->m_depth[state] + 1U);
+                }
+
+                state = this->m_next[slot];
+            }
+
+            // Needles listed twice end in the same state, keep them in order
+            auto *last = &this->m_state_pattern[state];
+            while (*last != no_state) last = &this->m_same_pattern[*last];
+            *last = static_cast<state_type>(id);
+        }
+
+        // Failure links, breadth first, folded into the transition table
+        std::vector<state_type> fail(this->m_depth.size(), 0U);
+        std::vector<state_type> queue;
+        queue.reserve(this->m_depth.size());
+
+        for (size_type c = 0UL; c < this->m_classes; ++c)
+        {
+            auto &next = this->m_next[c];
+
+            if (next == no_state)
+            {
+                next = 0U;
+            }
+            else
+            {
+                queue.push_back(next);
+            }
+        }
+
+        for (size_type head = 0UL; head < queue.size(); ++head)
+        {
+            const state_type state = queue[head];
+
+            this->m_output[state] = (this->m_state_pattern[state] != no_state) ? state
+                                                                               : this->m_output[fail[state]];
+            if (this->m_state_pattern[state] != no_state)
+            {
+                this->m_output_link[state] = this->m_output[fail[state]];
+            }
+
+            for (size_type c = 0UL; c < this->m_classes; ++c)
+            {
+                auto &next = this->m_next[(state * this->m_classes) + c];
+                const state_type fallback = this->m_next[(fail[state] * this->m_classes) + c];
+
+                if (next == no_state)
+                {
+                    next = fallback;
+                }
+                else
+                {
+                    fail[next] = fallback;
+                    queue.push_back(next);
+                }
+            }
+        }
+    }
+
+    state_type add_state(state_type depth)
+    {
+        const auto state = static_cast<state_type>(this->m_depth.size());
+
+        this->m_depth.push_back(depth);
+        this->m_output.push_back(no_state);
+        this->m_output_link.push_back(no_state);
+        this->m_state_pattern.push_back(no_state);
+        this->m_next.resize(this->m_next.size() + this->m_classes, no_state);
+
+        return state;
+    }
+
+
+private:
+    std::vector<CharT>     m_chars;    // the needles, back to back
+    std::vector<size_type> m_offsets;  // where each needle starts in m_chars
+
+    // Fingerprint prefilter
+    std::array<std::uint8_t, 32UL * string_view_detail::teddy_max_width> m_teddy_masks{};
+    size_type m_teddy_width = 0UL;     // 0 when the automaton is used
+
+    // Automaton
+    size_type m_classes = 0UL;                                // size of the compressed alphabet
+    std::array<state_type, 256> m_byte_class{};              // class of the characters below 256
+    std::vector<wide_class> m_wide_class;                    // class of the wider ones
+    std::vector<state_type> m_next;           // transitions, m_classes per state
+    std::vector<state_type> m_depth;          // length of the prefix each state spells
+    std::vector<state_type> m_output;         // nearest state, self included, that ends a needle
+    std::vector<state_type> m_output_link;    // next such state along the failure chain
+    std::vector<state_type> m_state_pattern;  // first needle ending in each state
+    std::vector<state_type> m_same_pattern;   // next needle ending in the same state
+};
+
+
+/**
+* prevents a completely defined template from being instantiated by compilation units
+* except for our explicit instantiation.
+****/
+
+extern template class multi_searcher<char>;
+extern template class multi_searcher<wchar_t>;
+extern template class multi_searcher<char16_t>;
+extern template class multi_searcher<char32_t>;
+
+#endif
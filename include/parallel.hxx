@@ -0,0 +1,279 @@
+/***********************************************
+** @Copyright (C) 2018 - 2019 Mohammed ELomari.
+** @brief Multi-threaded search and count over large views.
+************************************************/
+#ifndef PARALLEL_HXX
+#define PARALLEL_HXX
+
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "split.hxx"
+#include "string_view.hxx"
+#include "thread_pool.hxx"
+
+
+/***
+* @brief Size of the pieces the parallel algorithms cut a view into
+* \note  Large enough to amortize scheduling, small enough to spread evenly
+*        over the workers and to stay in the private caches of a core.
+****/
+inline constexpr std::size_t parallel_chunk_bytes = std::size_t(1) << 20U;
+
+
+namespace string_view_detail
+{
+
+template <typename CharT>
+inline constexpr std::size_t parallel_chunk = parallel_chunk_bytes / sizeof(CharT);
+
+/***
+* @brief Cuts the match start positions [0, starts) of a needle of length
+*        \p m into chunks, and hands \p body the window of the haystack
+*        holding every match that starts in each chunk.
+* \note  Windows overlap by m - 1 characters, so a match crossing a chunk
+*        boundary is seen by the chunk where it starts, and only by it.
+****/
+template <typename CharT, typename Traits, typename Body>
+void for_each_window(basic_string_view<CharT, Traits> hay, std::size_t m, thread_pool &pool, Body &&body)
+{
+    const std::size_t starts = hay.size() - m + 1UL;
+    const std::size_t chunk  = parallel_chunk<CharT>;
+    const std::size_t chunks = (starts + chunk - 1UL) / chunk;
+
+    pool.parallel_for(chunks, [&](std::size_t i) {
+        const std::size_t first = i * chunk;
+        const std::size_t last  = std::min(first + chunk, starts);
+
+        body(i, first, basic_string_view<CharT, Traits>(( hay.data() + first ), ( last - first + m - 1UL )));
+    });
+}
+
+}  // namespace string_view_detail
+
+
+/***
+* @brief Finds the first occurrence of \p needle, using every worker of \p pool
+* \note  Returns the same position as hay.find(needle). Chunks are taken
+*        in order and skipped once an earlier chunk has a match.
+* @param hay    the view to search in
+* @param needle the view to search for
+* @param pool   the workers to run on
+* @return the position of the first match, or npos
+****/
+template <typename CharT, typename Traits>
+std::size_t parallel_find(basic_string_view<CharT, Traits> hay,
+                          std::type_identity_t<basic_string_view<CharT, Traits>> needle,
+                          thread_pool &pool = thread_pool::default_pool())
+{
+    using view_type = basic_string_view<CharT, Traits>;
+
+    if ((needle.size() > hay.size()) || ((hay.size() - needle.size()) < string_view_detail::parallel_chunk<CharT>))
+    {
+        return hay.find(needle);
+    }
+
+    std::atomic<std::size_t> best{view_type::npos};
+
+    string_view_detail::for_each_window(hay, needle.size(), pool, [&](std::size_t, std::size_t first, view_type window) {
+        if (first >= best.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        const std::size_t found = window.find(needle);
+
+        if (found == view_type::npos)
+        {
+            return;
+        }
+
+        std::size_t current = best.load(std::memory_order_relaxed);
+
+        while (((first + found) < current) && !best.compare_exchange_weak(current, first + found))
+        {
+        }
+    });
+
+    return best.load();
+}
+
+/***
+* @brief Counts the occurrences of \p needle, overlapping ones included
+* \note  An empty needle occurs at every position, hay.size() + 1 times.
+* @param hay    the view to search in
+* @param needle the view to search for
+* @param pool   the workers to run on
+* @return the number of positions where \p needle starts
+****/
+template <typename CharT, typename Traits>
+std::size_t parallel_count(basic_string_view<CharT, Traits> hay,
+                           std::type_identity_t<basic_string_view<CharT, Traits>> needle,
+                           thread_pool &pool = thread_pool::default_pool())
+{
+    using view_type = basic_string_view<CharT, Traits>;
+
+    if (needle.empty())
+    {
+        return hay.size() + 1UL;
+    }
+
+    if (needle.size() > hay.size())
+    {
+        return 0UL;
+    }
+
+    std::atomic<std::size_t> total{0UL};
+
+    string_view_detail::for_each_window(hay, needle.size(), pool, [&](std::size_t, std::size_t, view_type window) {
+        std::size_t count = 0UL;
+
+        for (std::size_t p = window.find(needle); p != view_type::npos; p = window.find(needle, p + 1UL))
+        {
+            ++count;
+        }
+
+        total.fetch_add(count, std::memory_order_relaxed);
+    });
+
+    return total.load();
+}
+
+/***
+* @brief Counts the occurrences of the character \p c
+* @param hay  the view to search in
+* @param c    the character to count
+* @param pool the workers to run on
+* @return the number of occurrences of \p c
+****/
+template <typename CharT, typename Traits>
+std::size_t parallel_count(basic_string_view<CharT, Traits> hay, CharT c,
+                           thread_pool &pool = thread_pool::default_pool())
+{
+    using view_type = basic_string_view<CharT, Traits>;
+
+    if (hay.empty())
+    {
+        return 0UL;
+    }
+
+    std::atomic<std::size_t> total{0UL};
+
+    string_view_detail::for_each_window(hay, 1UL, pool, [&](std::size_t, std::size_t, view_type window) {
+        const auto count = std::count_if(window.begin(), window.end(), [c](CharT x) { return Traits::eq(x, c); });
+
+        total.fetch_add(static_cast<std::size_t>(count), std::memory_order_relaxed);
+    });
+
+    return total.load();
+}
+
+/***
+* @brief Finds every occurrence of \p needle, overlapping ones included
+* @param hay    the view to search in
+* @param needle the view to search for
+* @param out    receives the positions, in increasing order
+* @param pool   the workers to run on
+* @return the output iterator past the last position written
+****/
+template <typename CharT, typename Traits, std::output_iterator<std::size_t> OutputIt>
+OutputIt parallel_find_all(basic_string_view<CharT, Traits> hay,
+                           std::type_identity_t<basic_string_view<CharT, Traits>> needle,
+                           OutputIt out, thread_pool &pool = thread_pool::default_pool())
+{
+    using view_type = basic_string_view<CharT, Traits>;
+
+    if (needle.empty())
+    {
+        for (std::size_t p = 0UL; p <= hay.size(); ++p) *out++ = p;
+        return out;
+    }
+
+    if (needle.size() > hay.size())
+    {
+        return out;
+    }
+
+    const std::size_t starts = hay.size() - needle.size() + 1UL;
+    std::vector<std::vector<std::size_t>> found(
+        (starts + string_view_detail::parallel_chunk<CharT> - 1UL) / string_view_detail::parallel_chunk<CharT>);
+
+    string_view_detail::for_each_window(hay, needle.size(), pool, [&](std::size_t i, std::size_t first, view_type window) {
+        for (std::size_t p = window.find(needle); p != view_type::npos; p = window.find(needle, p + 1UL))
+        {
+            found[i].push_back(first + p);
+        }
+    });
+
+    for (const auto &positions : found)
+    {
+        out = std::ranges::copy(positions, out).out;
+    }
+
+    return out;
+}
+
+/***
+* @brief Calls \p f on every line of \p hay, using every worker of \p pool
+* \note  Lines are the ones lines(hay) yields. Each chunk is extended to
+*        the end of the line it cuts through, and \p f is called from
+*        several threads at once, in no particular order.
+* @param hay  the view to split into lines
+* @param f    the function to call with each line
+* @param pool the workers to run on
+****/
+template <typename CharT, typename Traits, typename Function>
+void parallel_for_each_line(basic_string_view<CharT, Traits> hay, Function &&f,
+                            thread_pool &pool = thread_pool::default_pool())
+{
+    using view_type = basic_string_view<CharT, Traits>;
+
+    if (hay.empty())
+    {
+        return;
+    }
+
+    const std::size_t chunk  = string_view_detail::parallel_chunk<CharT>;
+    const std::size_t chunks = (hay.size() + chunk - 1UL) / chunk;
+
+    // A chunk owns the lines that start inside it. The boundaries are
+    // found once, up front: a search starts where the previous one
+    // ended, so a line spanning many chunks is only scanned once.
+    std::vector<std::size_t> starts(chunks + 1UL, hay.size());
+    starts[0] = 0UL;
+
+    for (std::size_t i = 1UL; i < chunks; ++i)
+    {
+        const std::size_t nominal = i * chunk;
+
+        if (starts[i - 1UL] >= nominal)
+        {
+            starts[i] = starts[i - 1UL];
+            continue;
+        }
+
+        const std::size_t newline = hay.find(CharT('\n'), nominal - 1UL);
+
+        starts[i] = (newline == view_type::npos) ? hay.size() : (newline + 1UL);
+    }
+
+    pool.parallel_for(chunks, [&](std::size_t i) {
+        const std::size_t first = starts[i];
+        const std::size_t last  = starts[i + 1UL];
+
+        if (first < last)
+        {
+            for (view_type line : lines(view_type(( hay.data() + first ), ( last - first ))))
+            {
+                f(line);
+            }
+        }
+    });
+}
+
+#endif
@@ -0,0 +1,396 @@
+/***********************************************
+** @Copyright (C) 2018 - 2019 Mohammed ELomari.
+** @brief Lazy ranges of the fields, lines and tokens of a view.
+************************************************/
+#ifndef SPLIT_HXX
+#define SPLIT_HXX
+
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+
+#include "string_view.hxx"
+
+
+/***
+* @brief Common iterator of the split ranges below
+* \note  The iterator remembers where the current slice starts and ends in
+*        the source view and asks its range for the next slice. It holds
+*        its own copy of the range, a view and a delimiter, so it stays
+*        valid once the range it came from is gone. Slices point into the
+*        original buffer, nothing is copied or allocated.
+* @tparam Range the range being iterated
+****/
+template <typename Range>
+class slice_iterator final
+{
+
+// Public Member Types
+public:
+    using view_type         = typename Range::view_type;
+    using size_type         = typename view_type::size_type;
+    using value_type        = view_type;
+    using difference_type   = std::ptrdiff_t;
+    using iterator_concept  = std::forward_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+
+
+// Constructors
+public:
+    constexpr slice_iterator() noexcept = default;
+
+    constexpr slice_iterator(const Range &range, size_type start) noexcept
+        : m_range(range)
+        , m_start(start)
+        , m_end(range.slice_end(start))
+    {
+    }
+
+
+// Operations
+public:
+    constexpr view_type operator*() const noexcept
+    {
+        return this->m_range.slice(this->m_start, this->m_end);
+    }
+
+    constexpr slice_iterator &operator++() noexcept
+    {
+        this->m_start = this->m_range.next_start(this->m_end);
+
+        if (this->m_start != view_type::npos)
+        {
+            this->m_end = this->m_range.slice_end(this->m_start);
+        }
+
+        return *this;
+    }
+
+    constexpr slice_iterator operator++(int) noexcept
+    {
+        slice_iterator it = *this;
+        ++(*this);
+        return it;
+    }
+
+    constexpr bool operator==(const slice_iterator &other) const noexcept
+    {
+        return this->m_start == other.m_start;
+    }
+
+    constexpr bool operator==(std::default_sentinel_t) const noexcept
+    {
+        return this->m_start == view_type::npos;
+    }
+
+
+private:
+    Range m_range{};                        // copy of the range being iterated
+    size_type m_start = view_type::npos;    // start of the current slice, npos past the end
+    size_type m_end   = view_type::npos;    // end of the current slice
+};
+
+
+/***
+* @brief The fields of a view, separated by a delimiter
+* \note  Follows std::views::split: consecutive delimiters give empty
+*        fields, a trailing delimiter gives a trailing empty field and an
+*        empty source gives no field. An empty delimiter does not split.
+* @tparam CharT the character type
+* @tparam Traits the character traits
+* @tparam Delimiter either a single character or a view
+****/
+template <typename CharT, typename Traits, typename Delimiter>
+class split_view final : public std::ranges::view_interface<split_view<CharT, Traits, Delimiter>>
+{
+
+// Public Member Types
+public:
+    using view_type = basic_string_view<CharT, Traits>;
+    using size_type = typename view_type::size_type;
+    using iterator  = slice_iterator<split_view>;
+
+
+// Constructors
+public:
+    constexpr split_view() noexcept = default;
+
+    constexpr split_view(view_type source, Delimiter delimiter) noexcept
+        : m_source(source)
+        , m_delimiter(delimiter)
+    {
+    }
+
+
+// Iterators
+public:
+    constexpr iterator begin() const noexcept
+    {
+        return this->m_source.empty() ? iterator() : iterator(*this, 0UL);
+    }
+
+    constexpr std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+
+
+// Private Member
+private:
+    friend iterator;
+
+    constexpr size_type delimiter_size() const noexcept
+    {
+        if constexpr (std::is_same_v<Delimiter, CharT>)
+        {
+            return 1UL;
+        }
+        else
+        {
+            return this->m_delimiter.size();
+        }
+    }
+
+    constexpr size_type slice_end(size_type start) const noexcept
+    {
+        const size_type end = (this->delimiter_size() == 0UL) ? view_type::npos
+                                                               : this->m_source.find(this->m_delimiter, start);
+
+        return (end == view_type::npos) ? this->m_source.size() : end;
+    }
+
+    constexpr size_type next_start(size_type end) const noexcept
+    {
+        return (end == this->m_source.size()) ? view_type::npos : (end + this->delimiter_size());
+    }
+
+    constexpr view_type slice(size_type start, size_type end) const noexcept
+    {
+        return view_type(( this->m_source.data() + start ), ( end - start ));
+    }
+
+
+private:
+    view_type m_source;     // the view being split
+    Delimiter m_delimiter{};  // what separates the fields
+};
+
+
+/***
+* @brief The lines of a view
+* \note  Lines end at '\n', a '\r' right before it is dropped. Like
+*        std::getline, a trailing newline does not start another line.
+* @tparam CharT the character type
+* @tparam Traits the character traits
+****/
+template <typename CharT, typename Traits>
+class lines_view final : public std::ranges::view_interface<lines_view<CharT, Traits>>
+{
+
+// Public Member Types
+public:
+    using view_type = basic_string_view<CharT, Traits>;
+    using size_type = typename view_type::size_type;
+    using iterator  = slice_iterator<lines_view>;
+
+
+// Constructors
+public:
+    constexpr lines_view() noexcept = default;
+
+    constexpr explicit lines_view(view_type source) noexcept : m_source(source) {}
+
+
+// Iterators
+public:
+    constexpr iterator begin() const noexcept
+    {
+        return this->m_source.empty() ? iterator() : iterator(*this, 0UL);
+    }
+
+    constexpr std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+
+
+// Private Member
+private:
+    friend iterator;
+
+    constexpr size_type slice_end(size_type start) const noexcept
+    {
+        const size_type end = this->m_source.find(CharT('\n'), start);
+
+        return (end == view_type::npos) ? this->m_source.size() : end;
+    }
+
+    constexpr size_type next_start(size_type end) const noexcept
+    {
+        return ((end + 1UL) >= this->m_source.size()) ? view_type::npos : (end + 1UL);
+    }
+
+    constexpr view_type slice(size_type start, size_type end) const noexcept
+    {
+        if ((end > start) && Traits::eq(this->m_source[end - 1UL], CharT('\r')))
+        {
+            --end;
+        }
+
+        return view_type(( this->m_source.data() + start ), ( end - start ));
+    }
+
+
+private:
+    view_type m_source;  // the view being split
+};
+
+
+/***
+* @brief The tokens of a view: maximal runs of characters outside a set
+* \note  Separators are skipped, so no token is ever empty. The view
+*        refers to the set of separators instead of copying it, so the
+*        set must outlive the view and its iterators. Copying the view
+*        never allocates, whatever the size of the set.
+* @tparam CharT the character type
+* @tparam Traits the character traits
+****/
+template <typename CharT, typename Traits>
+class tokens_view final : public std::ranges::view_interface<tokens_view<CharT, Traits>>
+{
+
+// Public Member Types
+public:
+    using view_type = basic_string_view<CharT, Traits>;
+    using size_type = typename view_type::size_type;
+    using iterator  = slice_iterator<tokens_view>;
+
+
+// Constructors
+public:
+    constexpr tokens_view() noexcept = default;
+
+    constexpr tokens_view(view_type source, const basic_char_set<CharT> &separators) noexcept
+        : m_source(source)
+        , m_separators(std::addressof(separators))
+    {
+    }
+
+    // A temporary set would be gone before the first token is read
+    tokens_view(view_type source, const basic_char_set<CharT> &&separators) = delete;
+
+
+// Iterators
+public:
+    constexpr iterator begin() const noexcept
+    {
+        if (this->m_separators == nullptr)
+        {
+            return iterator();
+        }
+
+        const size_type start = this->m_source.find_first_not_of(*this->m_separators);
+
+        return (start == view_type::npos) ? iterator() : iterator(*this, start);
+    }
+
+    constexpr std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+
+
+// Private Member
+private:
+    friend iterator;
+
+    constexpr size_type slice_end(size_type start) const noexcept
+    {
+        const size_type end = this->m_source.find_first_of(*this->m_separators, start);
+
+        return (end == view_type::npos) ? this->m_source.size() : end;
+    }
+
+    constexpr size_type next_start(size_type end) const noexcept
+    {
+        return this->m_source.find_first_not_of(*this->m_separators, end);
+    }
+
+    constexpr view_type slice(size_type start, size_type end) const noexcept
+    {
+        return view_type(( this->m_source.data() + start ), ( end - start ));
+    }
+
+
+private:
+    view_type m_source;                                      // the view being split
+    const basic_char_set<CharT> *m_separators = nullptr;    // what separates the tokens, owned by the caller
+};
+
+
+// Public Functions
+
+/***
+* @brief Splits a view on a delimiter
+* @param source    the view to split
+* @param delimiter the characters between two fields
+* @return a lazy range of the fields
+****/
+template <typename CharT, typename Traits>
+constexpr auto split(basic_string_view<CharT, Traits> source,
+                     std::type_identity_t<basic_string_view<CharT, Traits>> delimiter) noexcept
+{
+    return split_view<CharT, Traits, basic_string_view<CharT, Traits>>(source, delimiter);
+}
+
+/***
+* @brief Splits a view on a delimiter
+* @param source    the view to split
+* @param delimiter the character between two fields
+* @return a lazy range of the fields
+****/
+template <typename CharT, typename Traits>
+constexpr auto split(basic_string_view<CharT, Traits> source, CharT delimiter) noexcept
+{
+    return split_view<CharT, Traits, CharT>(source, delimiter);
+}
+
+/***
+* @brief Splits a view into lines
+* @param source the view to split
+* @return a lazy range of the lines, without their line terminators
+****/
+template <typename CharT, typename Traits>
+constexpr auto lines(basic_string_view<CharT, Traits> source) noexcept
+{
+    return lines_view<CharT, Traits>(source);
+}
+
+/***
+* @brief Splits a view into tokens
+* @param source     the view to split
+* @param separators the characters between two tokens, which must outlive
+*                   the range and its iterators
+* @return a lazy range of the tokens
+****/
+template <typename CharT, typename Traits>
+constexpr auto tokens(basic_string_view<CharT, Traits> source,
+                      const std::type_identity_t<basic_char_set<CharT>> &separators) noexcept
+{
+    return tokens_view<CharT, Traits>(source, separators);
+}
+
+template <typename CharT, typename Traits>
+auto tokens(basic_string_view<CharT, Traits> source,
+            const std::type_identity_t<basic_char_set<CharT>> &&separators) = delete;
+
+
+/***
+* @brief The slices point into the source buffer, not into the range, so
+*        they and the iterators may outlive the range like they outlive a
+*        std::string_view
+****/
+template <typename CharT, typename Traits, typename Delimiter>
+inline constexpr bool std::ranges::enable_borrowed_range<split_view<CharT, Traits, Delimiter>> = true;
+
+template <typename CharT, typename Traits>
+inline constexpr bool std::ranges::enable_borrowed_range<lines_view<CharT, Traits>> = true;
+
+template <typename CharT, typename Traits>
+inline constexpr bool std::ranges::enable_borrowed_range<tokens_view<CharT, Traits>> = true;
+
+#endif
@@ -13,6 +13,11 @@
 #include <ranges>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+
+#include "char_set.hxx"
+#include "instrument.hxx"
+#include "string_view_search.hxx"
 
 template <typename CharT, typename Traits = std::char_traits<CharT>>
 class basic_string_view final
@@ -289,7 +294,12 @@ public:
     ****/
     constexpr int compare(basic_string_view v) const noexcept
     {
+        STRING_VIEW_PROBE(instrumented_member::compare);
+
         const size_type rlen  = std::min(this->m_size, v.m_size);
+
+        STRING_VIEW_SCAN(rlen * sizeof(CharT));
+
         const int compare     = Traits::compare(this->m_str, v.m_str, rlen);
 
         return (compare ? compare
@@ -373,6 +383,67 @@ public:
         return this->substr(pos, count1).compare(basic_string_view<CharT, Traits>(s, count2));
     }
 
+    /***
+    * @brief Checks if the view begins with the given prefix
+    * @param v the prefix to look for
+    * @return true if this view starts with \p v
+    ****/
+    constexpr bool starts_with(basic_string_view v) const noexcept
+    {
+        return (this->m_size >= v.m_size) && (Traits::compare(this->m_str, v.m_str, v.m_size) == 0);
+    }
+
+    constexpr bool starts_with(char_type c) const noexcept
+    {
+        return !this->empty() && Traits::eq(this->front(), c);
+    }
+
+    constexpr bool starts_with(const_pointer s) const
+    {
+        return this->starts_with(basic_string_view<CharT, Traits>(s));
+    }
+
+    /***
+    * @brief Checks if the view ends with the given suffix
+    * @param v the suffix to look for
+    * @return true if this view ends with \p v
+    ****/
+    constexpr bool ends_with(basic_string_view v) const noexcept
+    {
+        return (this->m_size >= v.m_size) &&
+               (Traits::compare(( this->m_str + ( this->m_size - v.m_size ) ), v.m_str, v.m_size) == 0);
+    }
+
+    constexpr bool ends_with(char_type c) const noexcept
+    {
+        return !this->empty() && Traits::eq(this->back(), c);
+    }
+
+    constexpr bool ends_with(const_pointer s) const
+    {
+        return this->ends_with(basic_string_view<CharT, Traits>(s));
+    }
+
+    /***
+    * @brief Checks if the view contains the given substring
+    * @param v the substring to look for
+    * @return true if \p v occurs in this view
+    ****/
+    constexpr bool contains(basic_string_view v) const noexcept
+    {
+        return this->find(v) != basic_string_view::npos;
+    }
+
+    constexpr bool contains(char_type c) const noexcept
+    {
+        return this->find(c) != basic_string_view::npos;
+    }
+
+    constexpr bool contains(const_pointer s) const
+    {
+        return this->find(s) != basic_string_view::npos;
+    }
+
 // SEARCH
 public:
     /**
@@ -380,27 +451,46 @@ public:
     ***/
     constexpr size_type find(basic_string_view v, size_type pos = 0UL) const
     {
+        STRING_VIEW_PROBE(instrumented_member::find);
+
         // Can't find a substring if the substring is bigger than this
-        if (pos > this->size())
+        if ((pos > this->size()) || (v.size() > (this->size() - pos)))
         {
             return basic_string_view::npos;
         }
 
-        if ((pos + v.size()) > this->size())
+        STRING_VIEW_SCAN(( this->m_size - pos ) * sizeof(CharT));
+
+        if constexpr (basic_string_view::plain_traits)
         {
-            return basic_string_view::npos;
+            if (!std::is_constant_evaluated())
+            {
+                const size_type i = string_view_detail::forward_search(
+                    ( this->m_str + pos ), ( this->m_size - pos ), v.m_str, v.m_size);
+
+                return (i == basic_string_view::npos) ? i : (i + pos);
+            }
+        }
+        else if constexpr (string_view_detail::searchable_traits<Traits, CharT>)
+        {
+            if (!std::is_constant_evaluated() && !v.empty())
+            {
+                const size_type i = Traits::search(
+                    ( this->m_str + pos ), ( this->m_size - pos ), v.m_str, v.m_size);
+
+                return (i == basic_string_view::npos) ? i : (i + pos);
+            }
         }
 
-        const auto offset      = pos;
-        const auto increments  = this->size() - v.size();
+        const auto last = this->size() - v.size();
 
-        for (auto i = 0UL; i <= increments; ++i)
+        for (auto i = pos; i <= last; ++i)
         {
-            const auto j = i + offset;
+            STRING_VIEW_VERIFY(1UL);
 
-            if (substr(j, v.size()) == v)
+            if (Traits::compare(( this->m_str + i ), v.m_str, v.size()) == 0)
             {
-                return j;
+                return i;
             }
         }
 
@@ -409,6 +499,26 @@ public:
 
     constexpr size_type find(char_type c, size_type pos = 0UL) const
     {
+        // memchr and wmemchr beat the needle filter on a single character
+        if constexpr (basic_string_view::plain_traits && ((sizeof(CharT) == 1UL) || std::is_same_v<CharT, wchar_t>))
+        {
+            if (!std::is_constant_evaluated())
+            {
+                STRING_VIEW_PROBE(instrumented_member::find);
+
+                if (pos >= this->m_size)
+                {
+                    return basic_string_view::npos;
+                }
+
+                STRING_VIEW_SCAN(( this->m_size - pos ) * sizeof(CharT));
+
+                const const_pointer p = Traits::find(( this->m_str + pos ), ( this->m_size - pos ), c);
+
+                return (p == nullptr) ? basic_string_view::npos : static_cast<size_type>(p - this->m_str);
+            }
+        }
+
         return this->find(basic_string_view<CharT, Traits>(std::addressof(c), 1UL), pos);
     }
 
@@ -428,6 +538,8 @@ public:
     ***/
     constexpr size_type rfind(basic_string_view v, size_type pos = basic_string_view::npos) const
     {
+        STRING_VIEW_PROBE(instrumented_member::rfind);
+
         if (this->empty())
         {
             return v.empty() ? 0UL : basic_string_view::npos;
@@ -443,15 +555,33 @@ public:
             return basic_string_view::npos;
         }
 
-        auto i = std::min(pos, (this->size() - v.size()));
+        const auto last = std::min(pos, (this->size() - v.size()));
 
-        while (i != basic_string_view::npos)
+        STRING_VIEW_SCAN(( last + v.size() ) * sizeof(CharT));
+
+        if constexpr (basic_string_view::plain_traits)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                return string_view_detail::backward_search(this->m_str, ( last + v.size() ), v.m_str, v.m_size);
+            }
+        }
+        else if constexpr (string_view_detail::reverse_searchable_traits<Traits, CharT>)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                return Traits::rsearch(this->m_str, ( last + v.size() ), v.m_str, v.m_size);
+            }
+        }
+
+        for (auto i = last; i != basic_string_view::npos; --i)
         {
-            if (this->substr(i, v.size()) == v)
+            STRING_VIEW_VERIFY(1UL);
+
+            if (Traits::compare(( this->m_str + i ), v.m_str, v.size()) == 0)
             {
                 return i;
             }
-            --i;
         }
 
         return basic_string_view::npos;
@@ -478,8 +608,25 @@ public:
     ***/
     constexpr size_type find_first_of(basic_string_view v, size_type pos = 0UL) const
     {
+        if constexpr (basic_string_view::plain_traits || string_view_detail::ascii_folding_traits<Traits, CharT>)
+        {
+            // A set that would spill its ranges to the heap is scanned
+            // character by character instead, so this overload never allocates
+            if (basic_char_set<CharT>::fits_inline(v.m_str, v.m_size))
+            {
+                return this->find_first_of(basic_char_set<CharT>(v.m_str, v.m_size), pos);
+            }
+        }
+
+        STRING_VIEW_PROBE(instrumented_member::find_first_of);
+
         const auto max_index = this->size();
 
+        if (pos < max_index)
+        {
+            STRING_VIEW_SCAN(( max_index - pos ) * sizeof(CharT));
+        }
+
         for (auto i = pos; i < max_index; ++i)
         {
             if (this->is_one_of(this->m_str[i], v))
@@ -493,7 +640,7 @@ public:
 
     constexpr size_type find_first_of(char_type c, size_type pos = 0UL) const
     {
-        return this->find_first_of(basic_string_view<CharT, Traits>(std::addressof(c), 1UL), pos);
+        return this->find(c, pos);
     }
 
     constexpr size_type find_first_of(const_pointer s, size_type pos, size_type count) const
@@ -506,11 +653,34 @@ public:
         return this->find_first_of(basic_string_view<CharT, Traits>(s), pos);
     }
 
+    constexpr size_type find_first_of(const basic_char_set<CharT> &set, size_type pos = 0UL) const noexcept
+        requires (basic_string_view::plain_traits || string_view_detail::ascii_folding_traits<Traits, CharT>)
+    {
+        if constexpr (!basic_string_view::plain_traits)
+        {
+            return this->scan_forward(set.with_ascii_case(), pos, false);
+        }
+
+        return this->scan_forward(set, pos, false);
+    }
+
     /**
     * @brief find last occurrence of characters.
     ***/
     constexpr size_type find_last_of(basic_string_view v, size_type pos = basic_string_view::npos) const
     {
+        if constexpr (basic_string_view::plain_traits || string_view_detail::ascii_folding_traits<Traits, CharT>)
+        {
+            // A set that would spill its ranges to the heap is scanned
+            // character by character instead, so this overload never allocates
+            if (basic_char_set<CharT>::fits_inline(v.m_str, v.m_size))
+            {
+                return this->find_last_of(basic_char_set<CharT>(v.m_str, v.m_size), pos);
+            }
+        }
+
+        STRING_VIEW_PROBE(instrumented_member::find_last_of);
+
         if (this->empty())
         {
             return basic_string_view::npos;
@@ -518,6 +688,8 @@ public:
 
         const auto max_index = std::min(this->size() - 1UL, pos);
 
+        STRING_VIEW_SCAN(( max_index + 1UL ) * sizeof(CharT));
+
         for (auto i = 0UL; i <= max_index; ++i)
         {
             const auto j = max_index - i;
@@ -533,7 +705,7 @@ public:
 
     constexpr size_type find_last_of(char_type c, size_type pos = basic_string_view::npos) const
     {
-        return this->find_last_of(basic_string_view<CharT, Traits>(std::addressof(c), 1UL), pos);
+        return this->rfind(c, pos);
     }
 
     constexpr size_type find_last_of(const_pointer s, size_type pos, size_type count) const
@@ -546,13 +718,42 @@ public:
         return this->find_last_of(basic_string_view<CharT, Traits>(s), pos);
     }
 
+    constexpr size_type find_last_of(const basic_char_set<CharT> &set,
+                                     size_type pos = basic_string_view::npos) const noexcept
+        requires (basic_string_view::plain_traits || string_view_detail::ascii_folding_traits<Traits, CharT>)
+    {
+        if constexpr (!basic_string_view::plain_traits)
+        {
+            return this->scan_backward(set.with_ascii_case(), pos, false);
+        }
+
+        return this->scan_backward(set, pos, false);
+    }
+
     /**
     * @brief find first absence of characters.
     ***/
     constexpr size_type find_first_not_of(basic_string_view v, size_type pos = 0UL) const
     {
+        if constexpr (basic_string_view::plain_traits || string_view_detail::ascii_folding_traits<Traits, CharT>)
+        {
+            // A set that would spill its ranges to the heap is scanned
+            // character by character instead, so this overload never allocates
+            if (basic_char_set<CharT>::fits_inline(v.m_str, v.m_size))
+            {
+                return this->find_first_not_of(basic_char_set<CharT>(v.m_str, v.m_size), pos);
+            }
+        }
+
+        STRING_VIEW_PROBE(instrumented_member::find_first_not_of);
+
         const auto max_index = this->size();
 
+        if (pos < max_index)
+        {
+            STRING_VIEW_SCAN(( max_index - pos ) * sizeof(CharT));
+        }
+
         for (auto i = pos; i < max_index; ++i)
         {
             if (!this->is_one_of(this->m_str[i], v))
@@ -578,12 +779,35 @@ public:
     {
         return this->find_first_not_of(basic_string_view<CharT, Traits>(s), pos);
     }
+
+    constexpr size_type find_first_not_of(const basic_char_set<CharT> &set, size_type pos = 0UL) const noexcept
+        requires (basic_string_view::plain_traits || string_view_detail::ascii_folding_traits<Traits, CharT>)
+    {
+        if constexpr (!basic_string_view::plain_traits)
+        {
+            return this->scan_forward(set.with_ascii_case(), pos, true);
+        }
+
+        return this->scan_forward(set, pos, true);
+    }
     
     /**
     * @brief find last absence of characters.
     ***/
     constexpr size_type find_last_not_of(basic_string_view v, size_type pos = basic_string_view::npos) const
     {
+        if constexpr (basic_string_view::plain_traits || string_view_detail::ascii_folding_traits<Traits, CharT>)
+        {
+            // A set that would spill its ranges to the heap is scanned
+            // character by character instead, so this overload never allocates
+            if (basic_char_set<CharT>::fits_inline(v.m_str, v.m_size))
+            {
+                return this->find_last_not_of(basic_char_set<CharT>(v.m_str, v.m_size), pos);
+            }
+        }
+
+        STRING_VIEW_PROBE(instrumented_member::find_last_not_of);
+
         if (this->empty())
         {
             return basic_string_view::npos;
@@ -591,6 +815,8 @@ public:
 
         const auto max_index = std::min(this->size() - 1UL, pos);
 
+        STRING_VIEW_SCAN(( max_index + 1UL ) * sizeof(CharT));
+
         for (auto i = 0UL; i <= max_index; ++i)
         {
             const auto j = max_index - i;
@@ -619,6 +845,18 @@ public:
         return this->find_last_not_of(basic_string_view<CharT, Traits>(s), pos);
     }
 
+    constexpr size_type find_last_not_of(const basic_char_set<CharT> &set,
+                                         size_type pos = basic_string_view::npos) const noexcept
+        requires (basic_string_view::plain_traits || string_view_detail::ascii_folding_traits<Traits, CharT>)
+    {
+        if constexpr (!basic_string_view::plain_traits)
+        {
+            return this->scan_backward(set.with_ascii_case(), pos, true);
+        }
+
+        return this->scan_backward(set, pos, true);
+    }
+
 
 
 // Iterators
@@ -654,19 +892,98 @@ public:
     
 // Private Member
 private:
+    /***
+    * @brief Whether characters compare by plain equality, which lets the
+    *        search members hand their work to the vectorized engine.
+    ****/
+    static constexpr bool plain_traits = std::is_same_v<Traits, std::char_traits<CharT>>;
+
     /***
     * @brief Checks whether \p c is one of the characters in \p str
     * @param c the character to check
     * @param str the characters to compare against
     * @return true if \p c is one of the characters in \p str
     ****/
-    static bool is_one_of(CharT c, basic_string_view str)
+    static constexpr bool is_one_of(CharT c, basic_string_view str)
     {
-        for ( CharT chr: str ) if ( chr == c ) return true;
+        for ( CharT chr: str ) if ( Traits::eq(chr, c) ) return true;
 
         return false;
     }
 
+    /***
+    * @brief Finds the first character from \p pos on that is (or is not) in \p set
+    * @param set    the characters to look for
+    * @param pos    the position to start at
+    * @param negate whether to look for a character outside \p set
+    * @return the position of the character, or npos
+    ****/
+    constexpr size_type scan_forward(const basic_char_set<CharT> &set, size_type pos, bool negate) const noexcept
+    {
+        STRING_VIEW_PROBE(negate ? instrumented_member::find_first_not_of : instrumented_member::find_first_of);
+
+        if (pos >= this->m_size)
+        {
+            return basic_string_view::npos;
+        }
+
+        STRING_VIEW_SCAN(( this->m_size - pos ) * sizeof(CharT));
+
+        if (!std::is_constant_evaluated())
+        {
+            const size_type i = string_view_detail::find_in_set(
+                ( this->m_str + pos ), ( this->m_size - pos ), set, negate);
+
+            return (i == basic_string_view::npos) ? i : (i + pos);
+        }
+
+        for (auto i = pos; i < this->m_size; ++i)
+        {
+            if (set.contains(this->m_str[i]) != negate)
+            {
+                return i;
+            }
+        }
+
+        return basic_string_view::npos;
+    }
+
+    /***
+    * @brief Finds the last character up to \p pos that is (or is not) in \p set
+    * @param set    the characters to look for
+    * @param pos    the position to start at
+    * @param negate whether to look for a character outside \p set
+    * @return the position of the character, or npos
+    ****/
+    constexpr size_type scan_backward(const basic_char_set<CharT> &set, size_type pos, bool negate) const noexcept
+    {
+        STRING_VIEW_PROBE(negate ? instrumented_member::find_last_not_of : instrumented_member::find_last_of);
+
+        if (this->empty())
+        {
+            return basic_string_view::npos;
+        }
+
+        const auto last = std::min(this->size() - 1UL, pos);
+
+        STRING_VIEW_SCAN(( last + 1UL ) * sizeof(CharT));
+
+        if (!std::is_constant_evaluated())
+        {
+            return string_view_detail::rfind_in_set(this->m_str, ( last + 1UL ), set, negate);
+        }
+
+        for (auto i = last; i != basic_string_view::npos; --i)
+        {
+            if (set.contains(this->m_str[i]) != negate)
+            {
+                return i;
+            }
+        }
+
+        return basic_string_view::npos;
+    }
+
 
 private:
     const CharT *m_str;  // The internal string type
@@ -695,8 +1012,7 @@ template <typename CharT, typename Traits>
 auto operator<<(std::basic_ostream<CharT, Traits> &_output,
                 const basic_string_view<CharT, Traits> &_str)  -> std::basic_ostream<CharT, Traits> &
 {
-    std::ranges::copy(_str, std::ostream_iterator<CharT>(_output));
-    return _output;
+    return _output.write(_str.data(), static_cast<std::streamsize>(_str.size()));
 }
 
 template <typename CharT, typename Traits>
@@ -711,7 +1027,17 @@ template <typename CharT, typename Traits>
 inline constexpr bool operator==(const basic_string_view<CharT, Traits> &_lhs,
                                  const basic_string_view<CharT, Traits> &_rhs) noexcept
 {
-    return (_lhs.compare(_rhs) == 0UL);
+    STRING_VIEW_PROBE(instrumented_member::equal);
+
+    // Views of different sizes are never equal, no need to look at them
+    if (_lhs.size() != _rhs.size())
+    {
+        return false;
+    }
+
+    STRING_VIEW_SCAN(_lhs.size() * sizeof(CharT));
+
+    return (Traits::compare(_lhs.data(), _rhs.data(), _lhs.size()) == 0);
 }
 
 template <typename CharT, typename Traits>
@@ -746,7 +1072,7 @@ template <typename CharT, typename Traits>
 inline constexpr bool operator!=(const basic_string_view<CharT, Traits> &_lhs,
                                  const basic_string_view<CharT, Traits> &_rhs) noexcept
 {
-    return (_lhs.compare(_rhs) != 0UL);
+    return !(_lhs == _rhs);
 }
 
 template <typename CharT, typename Traits>
@@ -925,6 +1251,18 @@ using u16string_view = basic_string_view<char16_t>;
 using u32string_view = basic_string_view<char32_t>;
 
 
+/***
+* @brief Prints a UTF-16 or UTF-32 view as UTF-8 on a narrow stream
+* \note  The text is converted a buffer at a time, ill-formed sequences
+*        are printed as U+FFFD.
+* @param o   The output stream to print to
+* @param str the string to print
+* @return reference to the output stream
+****/
+auto operator<<(std::basic_ostream<char> &_output, const u16string_view &_str) -> std::basic_ostream<char> &;
+auto operator<<(std::basic_ostream<char> &_output, const u32string_view &_str) -> std::basic_ostream<char> &;
+
+
 /**
 * prevents a completely defined template from being instantiated by compilation units
 * except for our explicit instantiation. 
@@ -939,15 +1277,7 @@ extern template class basic_string_view<char32_t>;
 extern template auto operator<<(std::basic_ostream<char>&, const string_view&)
     -> std::basic_ostream<char>&;
 
-extern template auto operator<<(std::basic_ostream<char>&, const wstring_view&)
+extern template auto operator<<(std::basic_ostream<wchar_t>&, const wstring_view&)
     -> std::basic_ostream<wchar_t>&;
 
-extern template auto operator<<(std::basic_ostream<char>&,
-                                const u16string_view&)
-    -> std::basic_ostream<char>&;
-    
-extern template auto operator<<(std::basic_ostream<char>&,
-                                const u32string_view&)
-    -> std::basic_ostream<char>&;
-
 #endif
\ No newline at end of file
@@ -0,0 +1,83 @@
+/***********************************************
+** @Copyright (C) 2018 - 2019 Mohammed ELomari.
+** @brief Runtime substring search engine behind basic_string_view.
+************************************************/
+#ifndef STRING_VIEW_SEARCH_HXX
+#define STRING_VIEW_SEARCH_HXX
+
+
+#include <concepts>
+#include <cstddef>
+
+
+namespace string_view_detail
+{
+
+/***
+* @brief Finds the first occurrence of a needle in a haystack
+* \note  Characters are compared for plain equality, so this is only valid
+*        for std::char_traits. The kernel is picked once per process
+*        from the instruction sets the CPU supports. Candidates are
+*        filtered on the needle's first and last characters, and Two-Way
+*        finishes the search if the text keeps almost matching.
+* @param hay    the characters to search in
+* @param n      number of characters in \p hay
+* @param needle the characters to search for
+* @param m      number of characters in \p needle
+* @return the position of the first match, or npos
+****/
+template <typename CharT>
+std::size_t forward_search(const CharT *hay, std::size_t n,
+                           const CharT *needle, std::size_t m) noexcept;
+
+/***
+* @brief Finds the last occurrence of a needle in a haystack
+* @param hay    the characters to search in
+* @param n      number of characters in \p hay
+* @param needle the characters to search for
+* @param m      number of characters in \p needle
+* @return the position of the last match, or npos
+****/
+template <typename CharT>
+std::size_t backward_search(const CharT *hay, std::size_t n,
+                            const CharT *needle, std::size_t m) noexcept;
+
+/***
+* @brief Traits bringing their own runtime substring search
+* \note  Traits::search(hay, n, needle, m) follows forward_search, and
+*        basic_string_view::find calls it instead of comparing at every
+*        position when the traits compare characters in a non-plain way.
+****/
+template <typename Traits, typename CharT>
+concept searchable_traits = requires(const CharT *s, std::size_t n)
+{
+    { Traits::search(s, n, s, n) } -> std::same_as<std::size_t>;
+};
+
+/***
+* @brief Traits bringing their own runtime backward substring search
+* \note  Traits::rsearch(hay, n, needle, m) follows backward_search, and
+*        basic_string_view::rfind calls it the way find calls
+*        Traits::search.
+****/
+template <typename Traits, typename CharT>
+concept reverse_searchable_traits = requires(const CharT *s, std::size_t n)
+{
+    { Traits::rsearch(s, n, s, n) } -> std::same_as<std::size_t>;
+};
+
+/***
+* @brief Narrow traits folding the ASCII letters, like ascii_ci_traits
+* \note  Traits::fold(c) maps 'A' to 'Z' onto 'a' to 'z' and leaves every
+*        other character alone, so a character set matches under these
+*        traits once it holds both cases of its letters.
+****/
+template <typename Traits, typename CharT>
+concept ascii_folding_traits = (sizeof(CharT) == 1UL) && requires(CharT c)
+{
+    { Traits::fold(c) } -> std::same_as<CharT>;
+};
+
+}  // namespace string_view_detail
+
+#endif
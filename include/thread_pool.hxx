@@ -0,0 +1,181 @@
+/***********************************************
+** @Copyright (C) 2018 - 2019 Mohammed ELomari.
+** @brief A small work-stealing thread pool for the parallel algorithms.
+************************************************/
+#ifndef THREAD_POOL_HXX
+#define THREAD_POOL_HXX
+
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+/***
+* @brief A fixed set of worker threads, each with its own task queue
+* \note  Workers run their own queue newest first and, once it is empty,
+*        steal the oldest task of another worker. Tasks submitted from a
+*        worker land on that worker's queue, others are spread round-robin.
+*        The pool can be shared with the rest of an application: the
+*        parallel algorithms take it by reference.
+****/
+class thread_pool final
+{
+
+// Public Member Types
+public:
+    using size_type = std::size_t;
+    using task_type = std::function<void()>;
+
+
+// Constructors
+public:
+    /***
+    * @brief Starts the worker threads
+    * @param threads the number of workers, at least one
+    ****/
+    explicit thread_pool(size_type threads = std::thread::hardware_concurrency());
+
+    thread_pool(const thread_pool &) = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    /***
+    * @brief Runs the pending tasks, then joins the worker threads
+    ****/
+    ~thread_pool();
+
+
+// Capacity
+public:
+    /***
+    * @brief Returns the number of worker threads
+    ****/
+    size_type size() const noexcept { return this->m_workers.size(); }
+
+
+// Operations
+public:
+    /***
+    * @brief Queues a task
+    * @param task the task to run on one of the workers
+    ****/
+    void submit(task_type task);
+
+    /***
+    * @brief Runs \p body(i) for every i in [0, count) and waits for them
+    * \note  The calling thread takes part, so this may be called from a
+    *        task of the same pool without deadlocking.
+    * @param count the number of iterations
+    * @param body  the function to run, must be safe to call concurrently
+    ****/
+    template <typename Body>
+    void parallel_for(size_type count, Body &&body);
+
+    /***
+    * @brief Returns the pool shared by default between all the parallel
+    *        algorithms, with one worker per hardware thread
+    ****/
+    static thread_pool &default_pool();
+
+
+// Private Member
+private:
+    struct worker
+    {
+        std::mutex mutex;            // guards the queue
+        std::deque<task_type> queue; // tasks, newest at the back
+        std::thread thread;
+    };
+
+    void run(size_type index);
+
+    void stop() noexcept;
+
+    bool pop(size_type index, task_type &task);
+
+
+private:
+    std::vector<std::unique_ptr<worker>> m_workers;
+    std::mutex m_mutex;                     // guards the sleep below
+    std::condition_variable m_wake;         // signalled when work arrives
+    std::atomic<size_type> m_pending{0UL};  // queued tasks not yet started
+    std::atomic<size_type> m_next{0UL};     // round-robin cursor for outside submits
+    bool m_stop = false;
+};
+
+
+template <typename Body>
+void thread_pool::parallel_for(size_type count, Body &&body)
+{
+    if (count == 0UL)
+    {
+        return;
+    }
+
+    // Shared with the helpers, which may start after this call returned
+    struct state
+    {
+        std::atomic<size_type> next{0UL};
+        std::atomic<size_type> done{0UL};
+        size_type count;
+        std::remove_reference_t<Body> *body;
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::exception_ptr error;  // first exception thrown by body
+    };
+
+    auto shared   = std::make_shared<state>();
+    shared->count = count;
+    shared->body  = std::addressof(body);
+
+    const auto drain = [](state &s) {
+        size_type ran = 0UL;
+
+        for (size_type i; (i = s.next.fetch_add(1UL)) < s.count; ++ran)
+        {
+            try
+            {
+                (*s.body)(i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(s.mutex);
+                if (!s.error) s.error = std::current_exception();
+            }
+        }
+
+        if ((ran != 0UL) && ((s.done.fetch_add(ran) + ran) == s.count))
+        {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.finished.notify_all();
+        }
+    };
+
+    const size_type helpers = std::min(count, this->size() + 1UL) - 1UL;
+
+    for (size_type h = 0UL; h < helpers; ++h)
+    {
+        this->submit([shared, drain] { drain(*shared); });
+    }
+
+    drain(*shared);
+
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    shared->finished.wait(lock, [&shared] { return shared->done.load() == shared->count; });
+
+    if (shared->error)
+    {
+        std::rethrow_exception(shared->error);
+    }
+}
+
+#endif
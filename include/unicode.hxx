@@ -0,0 +1,93 @@
+/***********************************************
+** @Copyright (C) 2018 - 2019 Mohammed ELomari.
+** @brief Validation of and transcoding between UTF-8, UTF-16 and UTF-32 views.
+************************************************/
+#ifndef UNICODE_HXX
+#define UNICODE_HXX
+
+
+#include <cstddef>
+
+#include "string_view.hxx"
+
+
+/***
+* @brief Why a transcoding stopped
+****/
+enum class utf_status
+{
+    ok,          // the whole input was converted
+    invalid,     // the input holds an ill-formed sequence
+    incomplete,  // the input ends in the middle of a sequence
+    output_full  // the next code point does not fit in the output
+};
+
+/***
+* @brief Outcome of a transcoding
+* \note  On anything but ok, \p read is the position of the sequence that
+*        stopped the conversion, so the call can be resumed from there once
+*        the output is drained or more input is available.
+****/
+struct utf_result
+{
+    utf_status status;
+    std::size_t read;     // input code units consumed
+    std::size_t written;  // output code units produced
+};
+
+
+// Validation
+
+/***
+* @brief Checks that \p str is well-formed UTF-8
+* \note  Overlong forms, surrogates and code points past U+10FFFF are
+*        rejected. Vectorized when the CPU supports AVX2.
+****/
+bool is_valid_utf8(string_view str) noexcept;
+
+/***
+* @brief Checks that \p str is well-formed UTF-16, without lone surrogates
+****/
+bool is_valid_utf16(u16string_view str) noexcept;
+
+/***
+* @brief Checks that \p str only holds Unicode scalar values
+****/
+bool is_valid_utf32(u32string_view str) noexcept;
+
+
+// Lengths
+
+/***
+* @brief Returns the number of code units the conversion of \p str takes
+* \note  Meant to size the output of the transcoding functions. The result
+*        is only exact for well-formed input.
+****/
+std::size_t utf8_length(u16string_view str) noexcept;
+std::size_t utf8_length(u32string_view str) noexcept;
+std::size_t utf16_length(string_view str) noexcept;
+std::size_t utf16_length(u32string_view str) noexcept;
+std::size_t utf32_length(string_view str) noexcept;
+std::size_t utf32_length(u16string_view str) noexcept;
+
+
+// Transcoding
+
+/***
+* @brief Converts \p str into the buffer [out, out + capacity)
+* \note  Nothing is allocated. Runs of ASCII (or, between UTF-16 and
+*        UTF-32, of BMP characters outside the surrogate range) are
+*        converted a vector at a time.
+* @param str      the text to convert
+* @param out      where to write the converted text
+* @param capacity the number of code units \p out can hold
+* @return how far the conversion went, see utf_result
+****/
+utf_result to_utf8(u16string_view str, char *out, std::size_t capacity) noexcept;
+utf_result to_utf8(u32string_view str, char *out, std::size_t capacity) noexcept;
+utf_result to_utf16(string_view str, char16_t *out, std::size_t capacity) noexcept;
+utf_result to_utf16(u32string_view str, char16_t *out, std::size_t capacity) noexcept;
+utf_result to_utf32(string_view str, char32_t *out, std::size_t capacity) noexcept;
+utf_result to_utf32(u16string_view str, char32_t *out, std::size_t capacity) noexcept;
+
+#endif
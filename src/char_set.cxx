@@ -0,0 +1,111 @@
+#include <char_set.hxx>
+
+#include "char_set_kernels.hxx"
+#include "simd.hxx"
+
+
+namespace string_view_detail
+{
+
+std::size_t find_in_set(const char *s, std::size_t n,
+                        const basic_char_set<char> &set, bool negate) noexcept
+{
+#if defined(STRING_VIEW_SIMD_AVX2)
+    if (cpu_has_avx2())
+    {
+        return find_in_set_avx2(s, n, set.m_bits.data(), set.m_nibbles.data(), negate);
+    }
+#endif
+
+    for (std::size_t i = 0UL; i < n; ++i)
+    {
+        if (in_bitmap(set.m_bits.data(), s[i]) != negate)
+        {
+            return i;
+        }
+    }
+
+    return std::size_t(-1L);
+}
+
+std::size_t rfind_in_set(const char *s, std::size_t n,
+                         const basic_char_set<char> &set, bool negate) noexcept
+{
+#if defined(STRING_VIEW_SIMD_AVX2)
+    if (cpu_has_avx2())
+    {
+        return rfind_in_set_avx2(s, n, set.m_bits.data(), set.m_nibbles.data(), negate);
+    }
+#endif
+
+    for (std::size_t i = n; i-- > 0UL;)
+    {
+        if (in_bitmap(set.m_bits.data(), s[i]) != negate)
+        {
+            return i;
+        }
+    }
+
+    return std::size_t(-1L);
+}
+
+template <typename CharT>
+std::size_t find_in_set(const CharT *s, std::size_t n,
+                        const basic_char_set<CharT> &set, bool negate) noexcept
+{
+#if defined(STRING_VIEW_SIMD_AVX2)
+    if (cpu_has_avx2())
+    {
+        const wide_set_tables<std::make_unsigned_t<CharT>> tables{
+            set.m_bits.data(), set.m_nibbles.data(), set.m_filter.data(), set.ranges(), set.m_range_count};
+
+        return find_in_wide_set_avx2(s, n, tables, negate);
+    }
+#endif
+
+    for (std::size_t i = 0UL; i < n; ++i)
+    {
+        if (set.contains(s[i]) != negate)
+        {
+            return i;
+        }
+    }
+
+    return std::size_t(-1L);
+}
+
+template <typename CharT>
+std::size_t rfind_in_set(const CharT *s, std::size_t n,
+                         const basic_char_set<CharT> &set, bool negate) noexcept
+{
+#if defined(STRING_VIEW_SIMD_AVX2)
+    if (cpu_has_avx2())
+    {
+        const wide_set_tables<std::make_unsigned_t<CharT>> tables{
+            set.m_bits.data(), set.m_nibbles.data(), set.m_filter.data(), set.ranges(), set.m_range_count};
+
+        return rfind_in_wide_set_avx2(s, n, tables, negate);
+    }
+#endif
+
+    for (std::size_t i = n; i-- > 0UL;)
+    {
+        if (set.contains(s[i]) != negate)
+        {
+            return i;
+        }
+    }
+
+    return std::size_t(-1L);
+}
+
+
+template std::size_t find_in_set(const wchar_t *, std::size_t, const basic_char_set<wchar_t> &, bool) noexcept;
+template std::size_t find_in_set(const char16_t *, std::size_t, const basic_char_set<char16_t> &, bool) noexcept;
+template std::size_t find_in_set(const char32_t *, std::size_t, const basic_char_set<char32_t> &, bool) noexcept;
+
+template std::size_t rfind_in_set(const wchar_t *, std::size_t, const basic_char_set<wchar_t> &, bool) noexcept;
+template std::size_t rfind_in_set(const char16_t *, std::size_t, const basic_char_set<char16_t> &, bool) noexcept;
+template std::size_t rfind_in_set(const char32_t *, std::size_t, const basic_char_set<char32_t> &, bool) noexcept;
+
+}  // namespace string_view_detail
@@ -0,0 +1,277 @@
+#include <type_traits>
+
+#include "char_set_kernels.hxx"
+#include "simd_avx2.hxx"
+
+
+namespace string_view_detail
+{
+
+namespace
+{
+
+/***
+* @brief Nibble-shuffle membership test of 32 bytes at once
+* \note  The low nibble of each byte picks an entry of one of the two
+*        tables (bit 7 of the byte selects which one, as vpshufb zeroes
+*        the lanes whose index has bit 7 set). The entry holds one bit per
+*        value of the high nibble, which a third shuffle turns into a
+*        selector bit.
+* @return one bit per byte, set if the byte is in the set
+****/
+inline std::uint32_t classify(__m256i v, __m256i lo_table, __m256i hi_table) noexcept
+{
+    const __m256i selector = _mm256_setr_epi8(
+        1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+        1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+
+    const __m256i low  = _mm256_shuffle_epi8(lo_table, v);
+    const __m256i high = _mm256_shuffle_epi8(hi_table, _mm256_xor_si256(v, _mm256_set1_epi8(-128)));
+    const __m256i hi_nibble = _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+    const __m256i bit  = _mm256_shuffle_epi8(selector, hi_nibble);
+    const __m256i miss = _mm256_cmpeq_epi8(
+        _mm256_and_si256(_mm256_or_si256(low, high), bit), _mm256_setzero_si256());
+
+    return ~static_cast<std::uint32_t>(_mm256_movemask_epi8(miss));
+}
+
+inline __m256i load_table(const std::uint8_t *table) noexcept
+{
+    return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(table)));
+}
+
+/***
+* @brief Narrows 32 wide characters to bytes the classifier can take
+* \note  The packs saturate, so the bytes of the characters of 256 and
+*        more are meaningless: \p wide tells which ones those are.
+* @param s    the characters to narrow
+* @param wide receives one bit per character of 256 or more
+* @return the 32 characters below 256, as bytes in their order
+****/
+template <typename CharT>
+inline __m256i narrow(const CharT *s, std::uint32_t &wide) noexcept
+{
+    const __m256i zero = _mm256_setzero_si256();
+
+    if constexpr (sizeof(CharT) == 2UL)
+    {
+        const __m256i a = avx2_ops::load(s);
+        const __m256i b = avx2_ops::load(s + 16);
+
+        const __m256i small = _mm256_packs_epi16(_mm256_cmpeq_epi16(_mm256_srli_epi16(a, 8), zero),
+                                                 _mm256_cmpeq_epi16(_mm256_srli_epi16(b, 8), zero));
+
+        wide = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_permute4x64_epi64(small, 0xD8)));
+
+        return _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+    }
+    else
+    {
+        // The two packs leave 4-character groups in the order 0 2 4 6 1 3 5 7
+        const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+        const __m256i a = avx2_ops::load(s);
+        const __m256i b = avx2_ops::load(s + 8);
+        const __m256i c = avx2_ops::load(s + 16);
+        const __m256i d = avx2_ops::load(s + 24);
+
+        const __m256i small = _mm256_packs_epi16(
+            _mm256_packs_epi32(_mm256_cmpeq_epi32(_mm256_srli_epi32(a, 8), zero),
+                               _mm256_cmpeq_epi32(_mm256_srli_epi32(b, 8), zero)),
+            _mm256_packs_epi32(_mm256_cmpeq_epi32(_mm256_srli_epi32(c, 8), zero),
+                               _mm256_cmpeq_epi32(_mm256_srli_epi32(d, 8), zero)));
+
+        wide = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_permutevar8x32_epi32(small, order)));
+
+        return _mm256_permutevar8x32_epi32(
+            _mm256_packus_epi16(_mm256_packus_epi32(a, b), _mm256_packus_epi32(c, d)), order);
+    }
+}
+
+/***
+* @brief Returns the wide characters of a block that are in the set
+****/
+template <typename CharT>
+inline std::uint32_t wide_members(const CharT *s, std::uint32_t wide,
+                                  const wide_set_tables<std::make_unsigned_t<CharT>> &tables) noexcept
+{
+    std::uint32_t members = 0U;
+
+    for (; wide != 0U; wide &= wide - 1U)
+    {
+        const unsigned bit = lowest_bit(wide);
+        const auto u = static_cast<std::make_unsigned_t<CharT>>(s[bit]);
+
+        if (in_filter(tables.filter, u) && in_ranges(tables.ranges, tables.range_count, u))
+        {
+            members |= 1U << bit;
+        }
+    }
+
+    return members;
+}
+
+/***
+* @brief Returns the characters of a block of 32 that are (or are not) in the set
+****/
+template <typename CharT>
+inline std::uint32_t classify_wide(const CharT *s, const wide_set_tables<std::make_unsigned_t<CharT>> &tables,
+                                   __m256i lo_table, __m256i hi_table, bool negate) noexcept
+{
+    std::uint32_t wide  = 0U;
+    const __m256i bytes = narrow(s, wide);
+    std::uint32_t hits  = (classify(bytes, lo_table, hi_table) ^ (negate ? ~0U : 0U)) & ~wide;
+
+    if (wide != 0U)
+    {
+        const std::uint32_t members = (tables.range_count != 0UL) ? wide_members(s, wide, tables) : 0U;
+
+        hits |= negate ? (wide & ~members) : members;
+    }
+
+    return hits;
+}
+
+}  // namespace
+
+
+std::size_t find_in_set_avx2(const char *s, std::size_t n, const std::uint64_t *bits,
+                             const std::uint8_t *nibbles, bool negate) noexcept
+{
+    const __m256i lo_table = load_table(nibbles);
+    const __m256i hi_table = load_table(nibbles + 16);
+    const std::uint32_t flip = negate ? ~0U : 0U;
+
+    std::size_t i = 0UL;
+
+    for (; i + avx2_ops::width <= n; i += avx2_ops::width)
+    {
+        const std::uint32_t mask = classify(avx2_ops::load(s + i), lo_table, hi_table) ^ flip;
+
+        if (mask != 0U)
+        {
+            return i + lowest_bit(mask);
+        }
+    }
+
+    for (; i < n; ++i)
+    {
+        if (in_bitmap(bits, s[i]) != negate)
+        {
+            return i;
+        }
+    }
+
+    return std::size_t(-1L);
+}
+
+std::size_t rfind_in_set_avx2(const char *s, std::size_t n, const std::uint64_t *bits,
+                              const std::uint8_t *nibbles, bool negate) noexcept
+{
+    const __m256i lo_table = load_table(nibbles);
+    const __m256i hi_table = load_table(nibbles + 16);
+    const std::uint32_t flip = negate ? ~0U : 0U;
+
+    std::size_t i = n;
+
+    for (; i >= avx2_ops::width; i -= avx2_ops::width)
+    {
+        const std::size_t block  = i - avx2_ops::width;
+        const std::uint32_t mask = classify(avx2_ops::load(s + block), lo_table, hi_table) ^ flip;
+
+        if (mask != 0U)
+        {
+            return block + highest_bit(mask);
+        }
+    }
+
+    while (i-- > 0UL)
+    {
+        if (in_bitmap(bits, s[i]) != negate)
+        {
+            return i;
+        }
+    }
+
+    return std::size_t(-1L);
+}
+
+template <typename CharT>
+std::size_t find_in_wide_set_avx2(const CharT *s, std::size_t n,
+                                  const wide_set_tables<std::make_unsigned_t<CharT>> &tables,
+                                  bool negate) noexcept
+{
+    const __m256i lo_table = load_table(tables.nibbles);
+    const __m256i hi_table = load_table(tables.nibbles + 16);
+
+    std::size_t i = 0UL;
+
+    for (; i + avx2_ops::width <= n; i += avx2_ops::width)
+    {
+        const std::uint32_t hits = classify_wide(s + i, tables, lo_table, hi_table, negate);
+
+        if (hits != 0U)
+        {
+            return i + lowest_bit(hits);
+        }
+    }
+
+    for (; i < n; ++i)
+    {
+        if (in_wide_set(tables, static_cast<std::make_unsigned_t<CharT>>(s[i])) != negate)
+        {
+            return i;
+        }
+    }
+
+    return std::size_t(-1L);
+}
+
+template <typename CharT>
+std::size_t rfind_in_wide_set_avx2(const CharT *s, std::size_t n,
+                                   const wide_set_tables<std::make_unsigned_t<CharT>> &tables,
+                                   bool negate) noexcept
+{
+    const __m256i lo_table = load_table(tables.nibbles);
+    const __m256i hi_table = load_table(tables.nibbles + 16);
+
+    std::size_t i = n;
+
+    for (; i >= avx2_ops::width; i -= avx2_ops::width)
+    {
+        const std::size_t block  = i - avx2_ops::width;
+        const std::uint32_t hits = classify_wide(s + block, tables, lo_table, hi_table, negate);
+
+        if (hits != 0U)
+        {
+            return block + highest_bit(hits);
+        }
+    }
+
+    while (i-- > 0UL)
+    {
+        if (in_wide_set(tables, static_cast<std::make_unsigned_t<CharT>>(s[i])) != negate)
+        {
+            return i;
+        }
+    }
+
+    return std::size_t(-1L);
+}
+
+
+template std::size_t find_in_wide_set_avx2(const wchar_t *, std::size_t,
+    const wide_set_tables<std::make_unsigned_t<wchar_t>> &, bool) noexcept;
+template std::size_t find_in_wide_set_avx2(const char16_t *, std::size_t,
+    const wide_set_tables<std::make_unsigned_t<char16_t>> &, bool) noexcept;
+template std::size_t find_in_wide_set_avx2(const char32_t *, std::size_t,
+    const wide_set_tables<std::make_unsigned_t<char32_t>> &, bool) noexcept;
+
+template std::size_t rfind_in_wide_set_avx2(const wchar_t *, std::size_t,
+    const wide_set_tables<std::make_unsigned_t<wchar_t>> &, bool) noexcept;
+template std::size_t rfind_in_wide_set_avx2(const char16_t *, std::size_t,
+    const wide_set_tables<std::make_unsigned_t<char16_t>> &, bool) noexcept;
+template std::size_t rfind_in_wide_set_avx2(const char32_t *, std::size_t,
+    const wide_set_tables<std::make_unsigned_t<char32_t>> &, bool) noexcept;
+
+}  // namespace string_view_detail
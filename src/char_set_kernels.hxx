@@ -0,0 +1,100 @@
+/***********************************************
+** @Copyright (C) 2018 - 2019 Mohammed ELomari.
+** @brief Character classification against a basic_char_set.
+************************************************/
+#ifndef STRING_VIEW_CHAR_SET_KERNELS_HXX
+#define STRING_VIEW_CHAR_SET_KERNELS_HXX
+
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <char_set.hxx>
+
+
+namespace string_view_detail
+{
+
+/***
+* @brief AVX2 classifiers, built in char_set_avx2.cxx
+* @param s       the characters to scan
+* @param n       number of characters in \p s
+* @param bits    the 256-bit membership bitmap of the set
+* @param nibbles the two 16-byte nibble tables of the set
+* @param negate  whether to look for characters outside the set
+* @return the position of the character, or npos
+****/
+std::size_t find_in_set_avx2(const char *s, std::size_t n, const std::uint64_t *bits,
+                             const std::uint8_t *nibbles, bool negate) noexcept;
+
+std::size_t rfind_in_set_avx2(const char *s, std::size_t n, const std::uint64_t *bits,
+                              const std::uint8_t *nibbles, bool negate) noexcept;
+
+
+/***
+* @brief The tables of a basic_char_set of wider characters
+****/
+template <typename UnsignedT>
+struct wide_set_tables
+{
+    const std::uint64_t *bits;              // members below 256
+    const std::uint8_t *nibbles;            // their classifier tables
+    const std::uint64_t *filter;            // hashes of the wider members
+    const char_range<UnsignedT> *ranges;    // the wider members
+    std::size_t range_count;                // number of ranges
+};
+
+/***
+* @brief AVX2 classifiers for the wider characters, built in char_set_avx2.cxx
+* \note  Characters below 256 are classified a vector at a time, the
+*        others through the filter and the ranges of the set.
+* @return the position of the first (last) character that is (or is not)
+*         in the set, or npos
+****/
+template <typename CharT>
+std::size_t find_in_wide_set_avx2(const CharT *s, std::size_t n,
+                                  const wide_set_tables<std::make_unsigned_t<CharT>> &tables,
+                                  bool negate) noexcept;
+
+template <typename CharT>
+std::size_t rfind_in_wide_set_avx2(const CharT *s, std::size_t n,
+                                   const wide_set_tables<std::make_unsigned_t<CharT>> &tables,
+                                   bool negate) noexcept;
+
+
+/***
+* @brief Checks a single byte against the membership bitmap
+****/
+inline bool in_bitmap(const std::uint64_t *bits, char c) noexcept
+{
+    const auto u = static_cast<unsigned char>(c);
+    return ((bits[u >> 6U] >> (u & 63U)) & 1U) != 0U;
+}
+
+/***
+* @brief Tells whether a wide character passes the filter of a set
+****/
+inline bool in_filter(const std::uint64_t *filter, std::uint32_t u) noexcept
+{
+    const std::size_t h = char_set_hash(u);
+    return ((filter[h >> 6U] >> (h & 63U)) & 1U) != 0U;
+}
+
+/***
+* @brief Checks a single character against the tables of a wide set
+****/
+template <typename UnsignedT>
+inline bool in_wide_set(const wide_set_tables<UnsignedT> &tables, UnsignedT u) noexcept
+{
+    if (u < 256U)
+    {
+        return ((tables.bits[u >> 6U] >> (u & 63U)) & 1U) != 0U;
+    }
+
+    return in_filter(tables.filter, u) && in_ranges(tables.ranges, tables.range_count, u);
+}
+
+}  // namespace string_view_detail
+
+#endif
@@ -0,0 +1,260 @@
+/***********************************************
+** @Copyright (C) 2018 - 2019 Mohammed ELomari.
+** @brief Vectorized ASCII case-insensitive compare and search.
+** \note  The kernels live in an anonymous namespace so every translation
+**        unit gets its own copy compiled for its own instruction set.
+************************************************/
+#ifndef STRING_VIEW_CI_KERNELS_HXX
+#define STRING_VIEW_CI_KERNELS_HXX
+
+
+#include <cstddef>
+#include <cstdint>
+
+#include "search_kernels.hxx"
+#include "simd.hxx"
+
+
+namespace string_view_detail
+{
+
+/***
+* @brief AVX2 instances of the kernels below, built in ci_string_view_avx2.cxx
+****/
+int compare_folded_avx2(const char *a, const char *b, std::size_t n) noexcept;
+
+std::size_t find_folded_avx2(const char *s, std::size_t n, char c) noexcept;
+
+filter_result search_folded_avx2(const char *hay, std::size_t n,
+                                 const char *needle, std::size_t m) noexcept;
+
+filter_result rsearch_folded_avx2(const char *hay, std::size_t n,
+                                  const char *needle, std::size_t m) noexcept;
+
+
+namespace
+{
+
+/***
+* @brief Lower cases an ASCII letter, leaves any other byte alone
+****/
+inline unsigned fold_byte(char c) noexcept
+{
+    const auto u = static_cast<unsigned char>(c);
+    return ((u - unsigned('A')) < 26U) ? (u | 0x20U) : u;
+}
+
+/***
+* @brief Lower cases the ASCII letters of a vector
+* \note  Shifting 'A' down to -128 turns the range check into a single
+*        signed comparison.
+****/
+template <typename Ops>
+inline typename Ops::vector fold(typename Ops::vector v) noexcept
+{
+    const auto upper = Ops::less_bytes(Ops::add_bytes(v, Ops::template splat<char>(char(0x80 - 'A'))),
+                                       Ops::template splat<char>(char(0x80 + 26)));
+
+    return Ops::bit_or(v, Ops::bit_and(upper, Ops::template splat<char>(char(0x20))));
+}
+
+/***
+* @brief Compares two byte sequences, ignoring ASCII case
+* @return the difference of the first folded bytes that differ, or 0
+****/
+template <typename Ops>
+int compare_folded(const char *a, const char *b, std::size_t n) noexcept
+{
+    std::size_t i = 0UL;
+
+    for (; (i + Ops::width) <= n; i += Ops::width)
+    {
+        const std::uint32_t same = Ops::mask(Ops::template cmpeq<char>(
+            fold<Ops>(Ops::load(a + i)), fold<Ops>(Ops::load(b + i))));
+
+        if (same != (std::uint32_t(-1) >> (32UL - Ops::width)))
+        {
+            const std::size_t j = i + lowest_bit(~same);
+            return static_cast<int>(fold_byte(a[j])) - static_cast<int>(fold_byte(b[j]));
+        }
+    }
+
+    for (; i < n; ++i)
+    {
+        if (fold_byte(a[i]) != fold_byte(b[i]))
+        {
+            return static_cast<int>(fold_byte(a[i])) - static_cast<int>(fold_byte(b[i]));
+        }
+    }
+
+    return 0;
+}
+
+/***
+* @brief Finds the first byte equal to \p c, ignoring ASCII case
+* @return the position of the byte, or npos
+****/
+template <typename Ops>
+std::size_t find_folded(const char *s, std::size_t n, char c) noexcept
+{
+    const auto target = Ops::template splat<char>(static_cast<char>(fold_byte(c)));
+
+    std::size_t i = 0UL;
+
+    for (; (i + Ops::width) <= n; i += Ops::width)
+    {
+        const std::uint32_t hits = Ops::mask(Ops::template cmpeq<char>(fold<Ops>(Ops::load(s + i)), target));
+
+        if (hits != 0U)
+        {
+            return i + lowest_bit(hits);
+        }
+    }
+
+    for (; i < n; ++i)
+    {
+        if (fold_byte(s[i]) == fold_byte(c))
+        {
+            return i;
+        }
+    }
+
+    return std::size_t(-1L);
+}
+
+/***
+* @brief Finds the first occurrence of \p needle, ignoring ASCII case
+* \note  Requires 1 <= m <= n. The first/last character filter of
+*        find_filtered, run on folded bytes, with the same verification
+*        budget.
+* @return the position of the match, or where the filter gave up
+****/
+template <typename Ops>
+filter_result search_folded(const char *hay, std::size_t n,
+                            const char *needle, std::size_t m) noexcept
+{
+    const std::size_t candidates = n - m + 1UL;
+    const auto first = Ops::template splat<char>(static_cast<char>(fold_byte(needle[0])));
+    const auto last  = Ops::template splat<char>(static_cast<char>(fold_byte(needle[m - 1UL])));
+
+    std::size_t i = 0UL;
+    std::size_t verified = 0UL;  // characters compared by failed verifications
+    std::size_t checks   = 0UL;
+
+    for (; (i + Ops::width) <= candidates; i += Ops::width)
+    {
+        std::uint32_t mask = Ops::mask(Ops::bit_and(
+            Ops::template cmpeq<char>(fold<Ops>(Ops::load(hay + i)), first),
+            Ops::template cmpeq<char>(fold<Ops>(Ops::load(hay + i + m - 1UL)), last)));
+
+        while (mask != 0U)
+        {
+            const std::size_t j = i + lowest_bit(mask);
+
+            ++checks;
+
+            if ((m <= 2UL) || (compare_folded<Ops>(hay + j + 1UL, needle + 1UL, m - 2UL) == 0))
+            {
+                return {j, std::size_t(-1L), checks};
+            }
+
+            verified += m;
+
+            if (verified > verification_budget(j, m))
+            {
+                return {std::size_t(-1L), j + 1UL, checks};
+            }
+
+            mask &= mask - 1U;
+        }
+    }
+
+    for (; i < candidates; ++i)
+    {
+        if (fold_byte(hay[i]) == fold_byte(needle[0]))
+        {
+            ++checks;
+
+            if (compare_folded<Ops>(hay + i, needle, m) == 0)
+            {
+                return {i, std::size_t(-1L), checks};
+            }
+        }
+    }
+
+    return {std::size_t(-1L), std::size_t(-1L), checks};
+}
+
+/***
+* @brief Finds the last occurrence of \p needle, ignoring ASCII case
+* \note  Requires 1 <= m <= n. Mirror image of search_folded, as
+*        rfind_filtered is of find_filtered: when it gives up, the
+*        candidates from resume on are ruled out.
+* @return the position of the match, or where the filter gave up
+****/
+template <typename Ops>
+filter_result rsearch_folded(const char *hay, std::size_t n,
+                             const char *needle, std::size_t m) noexcept
+{
+    const std::size_t candidates = n - m + 1UL;
+    const auto first = Ops::template splat<char>(static_cast<char>(fold_byte(needle[0])));
+    const auto last  = Ops::template splat<char>(static_cast<char>(fold_byte(needle[m - 1UL])));
+
+    std::size_t i = candidates;  // one past the last candidate
+    std::size_t verified = 0UL;  // characters compared by failed verifications
+    std::size_t checks   = 0UL;
+
+    while (i >= Ops::width)
+    {
+        const std::size_t block = i - Ops::width;
+
+        std::uint32_t mask = Ops::mask(Ops::bit_and(
+            Ops::template cmpeq<char>(fold<Ops>(Ops::load(hay + block)), first),
+            Ops::template cmpeq<char>(fold<Ops>(Ops::load(hay + block + m - 1UL)), last)));
+
+        while (mask != 0U)
+        {
+            const unsigned bit  = highest_bit(mask);
+            const std::size_t j = block + bit;
+
+            ++checks;
+
+            if ((m <= 2UL) || (compare_folded<Ops>(hay + j + 1UL, needle + 1UL, m - 2UL) == 0))
+            {
+                return {j, std::size_t(-1L), checks};
+            }
+
+            verified += m;
+
+            if (verified > verification_budget(candidates - j - 1UL, m))
+            {
+                return {std::size_t(-1L), j, checks};
+            }
+
+            mask &= ~(std::uint32_t(1U) << bit);
+        }
+
+        i = block;
+    }
+
+    while (i-- > 0UL)
+    {
+        if (fold_byte(hay[i]) == fold_byte(needle[0]))
+        {
+            ++checks;
+
+            if (compare_folded<Ops>(hay + i, needle, m) == 0)
+            {
+                return {i, std::size_t(-1L), checks};
+            }
+        }
+    }
+
+    return {std::size_t(-1L), std::size_t(-1L), checks};
+}
+
+}  // namespace
+
+}  // namespace string_view_detail
+
+#endif
@@ -0,0 +1,270 @@
+#include <ci_string_view.hxx>
+
+#include <instrument.hxx>
+
+#include "ci_kernels.hxx"
+#include "two_way.hxx"
+
+
+/**
+* Explicitly instantiate the case-insensitive view next to the four
+* plain ones.
+****/
+template class basic_string_view<char, ascii_ci_traits>;
+
+
+namespace string_view_detail
+{
+
+namespace
+{
+
+constexpr std::size_t not_found = std::size_t(-1L);
+
+/***
+* @brief Reads folded characters front to back, for Two-Way
+****/
+struct folded_sequence
+{
+    const char *first;
+
+    unsigned operator[](std::ptrdiff_t i) const noexcept { return fold_byte(this->first[i]); }
+};
+
+/***
+* @brief Reads folded characters back to front, for the backward Two-Way
+****/
+struct reverse_folded_sequence
+{
+    const char *last;  // one past the final character
+
+    unsigned operator[](std::ptrdiff_t i) const noexcept { return fold_byte(this->last[-1 - i]); }
+};
+
+}  // namespace
+
+
+#if !defined(STRING_VIEW_SIMD_SSE2)
+
+namespace
+{
+
+int compare_folded_scalar(const char *a, const char *b, std::size_t n) noexcept
+{
+    for (std::size_t i = 0UL; i < n; ++i)
+    {
+        if (fold_byte(a[i]) != fold_byte(b[i]))
+        {
+            return static_cast<int>(fold_byte(a[i])) - static_cast<int>(fold_byte(b[i]));
+        }
+    }
+
+    return 0;
+}
+
+std::size_t find_folded_scalar(const char *s, std::size_t n, char c) noexcept
+{
+    for (std::size_t i = 0UL; i < n; ++i)
+    {
+        if (fold_byte(s[i]) == fold_byte(c))
+        {
+            return i;
+        }
+    }
+
+    return std::size_t(-1L);
+}
+
+filter_result search_folded_scalar(const char *hay, std::size_t n,
+                                   const char *needle, std::size_t m) noexcept
+{
+    std::size_t verified = 0UL;
+    std::size_t checks   = 0UL;
+
+    for (std::size_t i = 0UL; (i + m) <= n; ++i)
+    {
+        if (fold_byte(hay[i]) == fold_byte(needle[0]))
+        {
+            ++checks;
+
+            if (compare_folded_scalar(hay + i, needle, m) == 0)
+            {
+                return {i, not_found, checks};
+            }
+
+            verified += m;
+
+            if (verified > verification_budget(i, m))
+            {
+                return {not_found, i + 1UL, checks};
+            }
+        }
+    }
+
+    return {not_found, not_found, checks};
+}
+
+filter_result rsearch_folded_scalar(const char *hay, std::size_t n,
+                                    const char *needle, std::size_t m) noexcept
+{
+    const std::size_t candidates = n - m + 1UL;
+    std::size_t verified = 0UL;
+    std::size_t checks   = 0UL;
+
+    for (std::size_t i = candidates; i-- > 0UL;)
+    {
+        if (fold_byte(hay[i]) == fold_byte(needle[0]))
+        {
+            ++checks;
+
+            if (compare_folded_scalar(hay + i, needle, m) == 0)
+            {
+                return {i, not_found, checks};
+            }
+
+            verified += m;
+
+            if (verified > verification_budget(candidates - i - 1UL, m))
+            {
+                return {not_found, i, checks};
+            }
+        }
+    }
+
+    return {not_found, not_found, checks};
+}
+
+}  // namespace
+
+#endif
+
+
+int ci_compare(const char *a, const char *b, std::size_t n) noexcept
+{
+#if defined(STRING_VIEW_SIMD_AVX2)
+    if (cpu_has_avx2())
+    {
+        return compare_folded_avx2(a, b, n);
+    }
+#endif
+
+#if defined(STRING_VIEW_SIMD_SSE2)
+    return compare_folded<sse2_ops>(a, b, n);
+#else
+    return compare_folded_scalar(a, b, n);
+#endif
+}
+
+std::size_t ci_find(const char *s, std::size_t n, char c) noexcept
+{
+#if defined(STRING_VIEW_SIMD_AVX2)
+    if (cpu_has_avx2())
+    {
+        return find_folded_avx2(s, n, c);
+    }
+#endif
+
+#if defined(STRING_VIEW_SIMD_SSE2)
+    return find_folded<sse2_ops>(s, n, c);
+#else
+    return find_folded_scalar(s, n, c);
+#endif
+}
+
+std::size_t ci_search(const char *hay, std::size_t n, const char *needle, std::size_t m) noexcept
+{
+    if (m == 0UL)
+    {
+        return 0UL;
+    }
+
+    if (m > n)
+    {
+        return not_found;
+    }
+
+    filter_result r;
+
+#if defined(STRING_VIEW_SIMD_AVX2)
+    if (cpu_has_avx2())
+    {
+        r = search_folded_avx2(hay, n, needle, m);
+    }
+    else
+#endif
+    {
+#if defined(STRING_VIEW_SIMD_SSE2)
+        r = search_folded<sse2_ops>(hay, n, needle, m);
+#else
+        r = search_folded_scalar(hay, n, needle, m);
+#endif
+    }
+
+    if (r.resume == not_found)
+    {
+        STRING_VIEW_VERIFIED(find, r.checks);
+        return r.position;
+    }
+
+    // The text keeps almost matching, finish the search in linear time
+    const std::size_t i = two_way(folded_sequence{hay + r.resume}, static_cast<std::ptrdiff_t>(n - r.resume),
+                                  folded_sequence{needle}, static_cast<std::ptrdiff_t>(m), r.checks);
+
+    STRING_VIEW_VERIFIED(find, r.checks);
+
+    return (i == not_found) ? not_found : (i + r.resume);
+}
+
+std::size_t ci_rsearch(const char *hay, std::size_t n, const char *needle, std::size_t m) noexcept
+{
+    if (m == 0UL)
+    {
+        return n;
+    }
+
+    if (m > n)
+    {
+        return not_found;
+    }
+
+    filter_result r;
+
+#if defined(STRING_VIEW_SIMD_AVX2)
+    if (cpu_has_avx2())
+    {
+        r = rsearch_folded_avx2(hay, n, needle, m);
+    }
+    else
+#endif
+    {
+#if defined(STRING_VIEW_SIMD_SSE2)
+        r = rsearch_folded<sse2_ops>(hay, n, needle, m);
+#else
+        r = rsearch_folded_scalar(hay, n, needle, m);
+#endif
+    }
+
+    if (r.resume == not_found)
+    {
+        STRING_VIEW_VERIFIED(rfind, r.checks);
+        return r.position;
+    }
+
+    // Only the candidates before resume are left, they end before resume + m - 1
+    const std::size_t rest = r.resume + m - 1UL;
+
+    if (rest < m)
+    {
+        STRING_VIEW_VERIFIED(rfind, r.checks);
+        return not_found;
+    }
+
+    const std::size_t i = two_way(reverse_folded_sequence{hay + rest}, static_cast<std::ptrdiff_t>(rest),
+                                  reverse_folded_sequence{needle + m}, static_cast<std::ptrdiff_t>(m), r.checks);
+
+    STRING_VIEW_VERIFIED(rfind, r.checks);
+
+    return (i == not_found) ? not_found : (rest - m - i);
+}
+
+}  // namespace string_view_detail
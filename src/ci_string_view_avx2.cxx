@@ -0,0 +1,30 @@
+#include "ci_kernels.hxx"
+#include "simd_avx2.hxx"
+
+
+namespace string_view_detail
+{
+
+int compare_folded_avx2(const char *a, const char *b, std::size_t n) noexcept
+{
+    return compare_folded<avx2_ops>(a, b, n);
+}
+
+std::size_t find_folded_avx2(const char *s, std::size_t n, char c) noexcept
+{
+    return find_folded<avx2_ops>(s, n, c);
+}
+
+filter_result search_folded_avx2(const char *hay, std::size_t n,
+                                 const char *needle, std::size_t m) noexcept
+{
+    return search_folded<avx2_ops>(hay, n, needle, m);
+}
+
+filter_result rsearch_folded_avx2(const char *hay, std::size_t n,
+                                  const char *needle, std::size_t m) noexcept
+{
+    return rsearch_folded<avx2_ops>(hay, n, needle, m);
+}
+
+}  // namespace string_view_detail
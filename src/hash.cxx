@@ -0,0 +1,80 @@
+#include <hash.hxx>
+
+#include "hash_kernels.hxx"
+#include "simd.hxx"
+
+
+namespace string_view_detail
+{
+
+namespace
+{
+
+/***
+* @brief Feeds \p stripes stripes of 64 bytes to the 8 lanes of \p acc
+* \note  Each lane adds the product of the two halves of its keyed word
+*        and the raw word of its neighbour. Lanes are scrambled after
+*        every block of 16 stripes.
+****/
+void hash_accumulate(std::uint64_t *acc, const unsigned char *p, std::size_t stripes) noexcept
+{
+    for (std::size_t s = 0UL; s < stripes; ++s, p += hash_stripe_bytes)
+    {
+        for (std::size_t i = 0UL; i < 8UL; ++i)
+        {
+            const std::uint64_t data = read8(p + (8UL * i));
+            const std::uint64_t key  = data ^ hash_stripe_key[i];
+
+            acc[i ^ 1UL] += data;
+            acc[i] += (key & 0xFFFFFFFFULL) * (key >> 32U);
+        }
+
+        if (((s + 1UL) % hash_block_stripes) == 0UL)
+        {
+            for (std::size_t i = 0UL; i < 8UL; ++i)
+            {
+                acc[i] ^= acc[i] >> 47U;
+                acc[i] ^= hash_scramble_key[i];
+                acc[i] *= hash_scramble_prime;
+            }
+        }
+    }
+}
+
+}  // namespace
+
+
+std::uint64_t hash_long(const unsigned char *p, std::size_t n, std::uint64_t seed) noexcept
+{
+    std::uint64_t acc[8] = {
+        0x00000000C2B2AE3DULL ^ seed, 0x9E3779B185EBCA87ULL, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL,
+        0x85EBCA77C2B2AE63ULL, 0x0000000085EBCA77ULL, 0x27D4EB2F165667C5ULL, 0x000000009E3779B1ULL ^ seed};
+
+    const std::size_t stripes = n / hash_stripe_bytes;
+
+#if defined(STRING_VIEW_SIMD_AVX2)
+    if (cpu_has_avx2())
+    {
+        hash_accumulate_avx2(acc, p, stripes);
+    }
+    else
+#endif
+    {
+        hash_accumulate(acc, p, stripes);
+    }
+
+    std::uint64_t h = seed ^ (n * hash_secret[0]);
+
+    for (std::size_t i = 0UL; i < 8UL; i += 2UL)
+    {
+        h ^= mix(acc[i] ^ hash_secret[i / 2UL], acc[i + 1UL] ^ h);
+    }
+
+    // The last partial stripe goes through the short path, seeded with
+    // everything accumulated so far
+    const std::size_t tail = n - (stripes * hash_stripe_bytes);
+
+    return hash_bytes(p + (n - tail), tail, h);
+}
+
+}  // namespace string_view_detail
@@ -0,0 +1,59 @@
+#include "hash_kernels.hxx"
+#include "simd_avx2.hxx"
+
+
+namespace string_view_detail
+{
+
+void hash_accumulate_avx2(std::uint64_t *acc, const unsigned char *p, std::size_t stripes) noexcept
+{
+    __m256i lanes[2] = {
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(acc)),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(acc + 4))};
+
+    const __m256i keys[2] = {
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(hash_stripe_key)),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(hash_stripe_key + 4))};
+
+    const __m256i scramble[2] = {
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(hash_scramble_key)),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(hash_scramble_key + 4))};
+
+    const __m256i prime = _mm256_set1_epi32(static_cast<int>(hash_scramble_prime));
+
+    for (std::size_t s = 0UL; s < stripes; ++s, p += hash_stripe_bytes)
+    {
+        for (std::size_t h = 0UL; h < 2UL; ++h)
+        {
+            const __m256i data = avx2_ops::load(p + (32UL * h));
+            const __m256i key  = _mm256_xor_si256(data, keys[h]);
+
+            // low half times high half of every keyed word
+            const __m256i product = _mm256_mul_epu32(key, _mm256_srli_epi64(key, 32));
+            // raw words go to the neighbouring lane
+            const __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+
+            lanes[h] = _mm256_add_epi64(lanes[h], _mm256_add_epi64(product, swapped));
+        }
+
+        if (((s + 1UL) % hash_block_stripes) == 0UL)
+        {
+            for (std::size_t h = 0UL; h < 2UL; ++h)
+            {
+                __m256i v = _mm256_xor_si256(lanes[h], _mm256_srli_epi64(lanes[h], 47));
+                v = _mm256_xor_si256(v, scramble[h]);
+
+                // 64-bit times 32-bit constant, from two 32x32 products
+                const __m256i lo = _mm256_mul_epu32(v, prime);
+                const __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(v, 32), prime);
+
+                lanes[h] = _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+            }
+        }
+    }
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(acc), lanes[0]);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(acc + 4), lanes[1]);
+}
+
+}  // namespace string_view_detail
@@ -0,0 +1,40 @@
+/***********************************************
+** @Copyright (C) 2018 - 2019 Mohammed ELomari.
+** @brief Striped accumulator of the long input hash.
+************************************************/
+#ifndef STRING_VIEW_HASH_KERNELS_HXX
+#define STRING_VIEW_HASH_KERNELS_HXX
+
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace string_view_detail
+{
+
+inline constexpr std::size_t hash_stripe_bytes   = 64UL;  // one stripe feeds the 8 lanes
+inline constexpr std::size_t hash_block_stripes  = 16UL;  // lanes are scrambled after each block
+inline constexpr std::uint64_t hash_scramble_prime = 0x9E3779B1ULL;
+
+/***
+* @brief Keys xored into the data of each stripe and into the lanes when
+*        they are scrambled
+****/
+inline constexpr std::uint64_t hash_stripe_key[8] = {
+    0xbe4ba423396cfeb8ULL, 0x1cad21f72c81017cULL, 0xdb979083e96dd4deULL, 0x1f67b3b7a4a44072ULL,
+    0x78e5c0cc4ee679cbULL, 0x2172ffcc7dd05a82ULL, 0x8e2443f7744608b8ULL, 0x4c263a81e69035e0ULL};
+
+inline constexpr std::uint64_t hash_scramble_key[8] = {
+    0xcb00c391bb52283cULL, 0xa32e531b8b65d088ULL, 0x4ef90da297486471ULL, 0xd8acdea946ef1938ULL,
+    0x3f349ce33f76faa8ULL, 0x1d4f0bc7c7bbdcf9ULL, 0x3159b4cd4be0518aULL, 0x647378d9c97e9fc8ULL};
+
+/***
+* @brief AVX2 accumulator, built in hash_avx2.cxx
+* \note  Same contract as the scalar accumulate in hash.cxx.
+****/
+void hash_accumulate_avx2(std::uint64_t *acc, const unsigned char *p, std::size_t stripes) noexcept;
+
+}  // namespace string_view_detail
+
+#endif
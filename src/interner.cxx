@@ -0,0 +1,11 @@
+#include <interner.hxx>
+
+
+/**
+* Explicitly instantiate only the classes
+* I want to support <char> , <wchar_t>, <char16_t> and <char32_t> with the same code.
+****/
+template class basic_interner<char>;
+template class basic_interner<wchar_t>;
+template class basic_interner<char16_t>;
+template class basic_interner<char32_t>;
@@ -0,0 +1,246 @@
+#include <mapped_file.hxx>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+
+namespace
+{
+
+[[noreturn]] void throw_errno(const char *what)
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+std::uint64_t page_size() noexcept
+{
+    static const auto size = static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+int to_advice(access_pattern pattern) noexcept
+{
+    switch (pattern)
+    {
+        case access_pattern::sequential: return POSIX_MADV_SEQUENTIAL;
+        case access_pattern::random:     return POSIX_MADV_RANDOM;
+        default:                         return POSIX_MADV_NORMAL;
+    }
+}
+
+}  // namespace
+
+
+// mapped_file
+
+mapped_file::mapped_file(const std::string &path, access_pattern pattern)
+    : mapped_file(path, 0UL, size_type(-1L), pattern)
+{
+}
+
+mapped_file::mapped_file(const std::string &path, std::uint64_t offset, size_type length,
+                         access_pattern pattern)
+    : m_pattern(pattern)
+{
+    this->m_fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (this->m_fd < 0)
+    {
+        throw_errno("mapped_file: cannot open file");
+    }
+
+    struct stat info{};
+
+    if (::fstat(this->m_fd, &info) != 0)
+    {
+        const int error = errno;
+        ::close(this->m_fd);
+        errno = error;
+        throw_errno("mapped_file: cannot stat file");
+    }
+
+    this->m_file_size = static_cast<std::uint64_t>(info.st_size);
+
+    try
+    {
+        this->remap(offset, length);
+    }
+    catch (...)
+    {
+        this->unmap();
+        ::close(this->m_fd);
+        throw;
+    }
+}
+
+mapped_file::mapped_file(mapped_file &&other) noexcept
+    : m_fd(std::exchange(other.m_fd, -1))
+    , m_file_size(std::exchange(other.m_file_size, 0UL))
+    , m_offset(std::exchange(other.m_offset, 0UL))
+    , m_base(std::exchange(other.m_base, nullptr))
+    , m_length(std::exchange(other.m_length, 0UL))
+    , m_data(std::exchange(other.m_data, nullptr))
+    , m_size(std::exchange(other.m_size, 0UL))
+    , m_pattern(other.m_pattern)
+{
+}
+
+mapped_file::~mapped_file()
+{
+    this->unmap();
+
+    if (this->m_fd >= 0)
+    {
+        ::close(this->m_fd);
+    }
+}
+
+mapped_file &mapped_file::operator=(mapped_file &&other) noexcept
+{
+    if (this != &other)
+    {
+        this->unmap();
+
+        if (this->m_fd >= 0)
+        {
+            ::close(this->m_fd);
+        }
+
+        this->m_fd        = std::exchange(other.m_fd, -1);
+        this->m_file_size = std::exchange(other.m_file_size, 0UL);
+        this->m_offset    = std::exchange(other.m_offset, 0UL);
+        this->m_base      = std::exchange(other.m_base, nullptr);
+        this->m_length    = std::exchange(other.m_length, 0UL);
+        this->m_data      = std::exchange(other.m_data, nullptr);
+        this->m_size      = std::exchange(other.m_size, 0UL);
+        this->m_pattern   = other.m_pattern;
+    }
+
+    return *this;
+}
+
+void mapped_file::remap(std::uint64_t offset, size_type length)
+{
+    this->unmap();
+
+    offset = std::min(offset, this->m_file_size);
+    length = static_cast<size_type>(std::min<std::uint64_t>(length, this->m_file_size - offset));
+
+    this->m_offset = offset;
+
+    if (length == 0UL)
+    {
+        return;
+    }
+
+    // mmap wants a page aligned offset, the window starts a bit further in
+    const std::uint64_t aligned = offset - (offset % page_size());
+    const auto lead = static_cast<size_type>(offset - aligned);
+
+    void *base = ::mmap(nullptr, lead + length, PROT_READ, MAP_PRIVATE, this->m_fd,
+                        static_cast<off_t>(aligned));
+
+    if (base == MAP_FAILED)
+    {
+        throw_errno("mapped_file: cannot map file");
+    }
+
+    this->m_base   = base;
+    this->m_length = lead + length;
+    this->m_data   = static_cast<const char *>(base) + lead;
+    this->m_size   = length;
+
+    // The advice is only a hint, a mapping the kernel would not advise is
+    // still a good mapping
+    if (this->m_pattern != access_pattern::normal)
+    {
+        ::posix_madvise(this->m_base, this->m_length, to_advice(this->m_pattern));
+    }
+}
+
+void mapped_file::advise(access_pattern pattern) const
+{
+    if (this->m_base == nullptr)
+    {
+        return;
+    }
+
+    const int error = ::posix_madvise(this->m_base, this->m_length, to_advice(pattern));
+
+    if (error != 0)
+    {
+        throw std::system_error(error, std::generic_category(), "mapped_file: cannot advise mapping");
+    }
+}
+
+bool mapped_file::advise_huge_pages() const noexcept
+{
+#if defined(MADV_HUGEPAGE)
+    return (this->m_base != nullptr) && (::madvise(this->m_base, this->m_length, MADV_HUGEPAGE) == 0);
+#else
+    return false;
+#endif
+}
+
+void mapped_file::unmap() noexcept
+{
+    if (this->m_base != nullptr)
+    {
+        ::munmap(this->m_base, this->m_length);
+    }
+
+    this->m_base   = nullptr;
+    this->m_length = 0UL;
+    this->m_data   = nullptr;
+    this->m_size   = 0UL;
+}
+
+
+// mapped_windows
+
+mapped_windows::mapped_windows(const std::string &path, size_type window_size, char boundary)
+    : m_file(path, 0UL, 0UL, access_pattern::sequential)
+    , m_window_size(std::max<size_type>(window_size, 1UL))
+    , m_boundary(boundary)
+{
+}
+
+mapped_windows::iterator mapped_windows::begin()
+{
+    this->load(0UL);
+    return iterator(this);
+}
+
+void mapped_windows::load(std::uint64_t offset)
+{
+    this->m_file.remap(offset, this->m_window_size);
+    this->m_done = this->m_file.empty();
+
+    string_view window = this->m_file.view();
+
+    // Cut after the last boundary, unless this is the tail of the file or
+    // a single record fills the whole window
+    if ((offset + window.size()) < this->m_file.file_size())
+    {
+        const auto last = window.rfind(this->m_boundary);
+
+        if (last != string_view::npos)
+        {
+            window = string_view(window.data(), last + 1UL);
+        }
+    }
+
+    this->m_current = window;
+}
+
+void mapped_windows::advance()
+{
+    this->load(this->m_file.offset() + this->m_current.size());
+}
@@ -0,0 +1,43 @@
+#include <multi_searcher.hxx>
+
+#include "multi_searcher_kernels.hxx"
+#include "simd.hxx"
+
+
+/**
+* Explicitly instantiate only the classes
+* I want to support <char> , <wchar_t>, <char16_t> and <char32_t> with the same code.
+****/
+template class multi_searcher<char>;
+template class multi_searcher<wchar_t>;
+template class multi_searcher<char16_t>;
+template class multi_searcher<char32_t>;
+
+
+namespace string_view_detail
+{
+
+bool teddy_supported() noexcept
+{
+#if defined(STRING_VIEW_SIMD_AVX2)
+    return cpu_has_avx2();
+#else
+    return false;
+#endif
+}
+
+std::size_t teddy_next(const char *s, std::size_t n, std::size_t from,
+                       const std::uint8_t *masks, std::size_t width,
+                       std::uint8_t &buckets) noexcept
+{
+#if defined(STRING_VIEW_SIMD_AVX2)
+    return teddy_next_avx2(s, n, from, masks, width, buckets);
+#else
+    // Unreachable, teddy_supported() never holds without the AVX2 kernel
+    static_cast<void>(s), static_cast<void>(n), static_cast<void>(from);
+    static_cast<void>(masks), static_cast<void>(width), static_cast<void>(buckets);
+    return std::size_t(-1L);
+#endif
+}
+
+}  // namespace string_view_detail
@@ -0,0 +1,65 @@
+#include "multi_searcher_kernels.hxx"
+#include "simd_avx2.hxx"
+
+
+namespace string_view_detail
+{
+
+std::size_t teddy_next_avx2(const char *s, std::size_t n, std::size_t from,
+                            const std::uint8_t *masks, std::size_t width,
+                            std::uint8_t &buckets) noexcept
+{
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+
+    __m256i lo_tables[3];
+    __m256i hi_tables[3];
+
+    for (std::size_t j = 0UL; j < width; ++j)
+    {
+        lo_tables[j] = _mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(masks + (32UL * j))));
+        hi_tables[j] = _mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(masks + (32UL * j) + 16UL)));
+    }
+
+    const std::size_t candidates = n - width + 1UL;
+    std::size_t i = from;
+
+    for (; i + avx2_ops::width <= candidates; i += avx2_ops::width)
+    {
+        __m256i hits = _mm256_set1_epi8(-1);
+
+        // Candidate lanes keep the buckets every fingerprinted character agrees on
+        for (std::size_t j = 0UL; j < width; ++j)
+        {
+            const __m256i v  = avx2_ops::load(s + i + j);
+            const __m256i lo = _mm256_shuffle_epi8(lo_tables[j], _mm256_and_si256(v, nibble));
+            const __m256i hi = _mm256_shuffle_epi8(hi_tables[j], _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+
+            hits = _mm256_and_si256(hits, _mm256_and_si256(lo, hi));
+        }
+
+        const std::uint32_t mask =
+            ~static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hits, _mm256_setzero_si256())));
+
+        if (mask != 0U)
+        {
+            const std::size_t lane = lowest_bit(mask);
+
+            buckets = teddy_buckets(s + i + lane, masks, width);
+            return i + lane;
+        }
+    }
+
+    for (; i < candidates; ++i)
+    {
+        if ((buckets = teddy_buckets(s + i, masks, width)) != 0U)
+        {
+            return i;
+        }
+    }
+
+    return std::size_t(-1L);
+}
+
+}  // namespace string_view_detail
@@ -0,0 +1,46 @@
+/***********************************************
+** @Copyright (C) 2018 - 2019 Mohammed ELomari.
+** @brief Fingerprint prefilter of multi_searcher.
+************************************************/
+#ifndef STRING_VIEW_MULTI_SEARCHER_KERNELS_HXX
+#define STRING_VIEW_MULTI_SEARCHER_KERNELS_HXX
+
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace string_view_detail
+{
+
+/***
+* @brief AVX2 fingerprint scan, built in multi_searcher_avx2.cxx
+* \note  Same contract as teddy_next.
+****/
+std::size_t teddy_next_avx2(const char *s, std::size_t n, std::size_t from,
+                            const std::uint8_t *masks, std::size_t width,
+                            std::uint8_t &buckets) noexcept;
+
+
+/***
+* @brief Buckets whose fingerprint matches at \p s
+* \note  Used by the AVX2 kernel to read back the buckets of the lane it
+*        stopped at, and to scan the positions left after the last vector.
+****/
+inline std::uint8_t teddy_buckets(const char *s, const std::uint8_t *masks, std::size_t width) noexcept
+{
+    std::uint8_t buckets = 0xFFU;
+
+    for (std::size_t j = 0UL; j < width; ++j)
+    {
+        const auto u = static_cast<unsigned char>(s[j]);
+
+        buckets &= masks[(32UL * j) + (u & 0x0FU)] & masks[(32UL * j) + 16UL + (u >> 4U)];
+    }
+
+    return buckets;
+}
+
+}  // namespace string_view_detail
+
+#endif
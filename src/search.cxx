@@ -0,0 +1,199 @@
+#include <string_view_search.hxx>
+
+#include <algorithm>
+
+#include <instrument.hxx>
+
+#include "search_kernels.hxx"
+#include "two_way.hxx"
+
+
+namespace string_view_detail
+{
+
+namespace
+{
+
+constexpr std::size_t not_found = std::size_t(-1L);
+
+
+#if !defined(STRING_VIEW_SIMD_SSE2)
+
+template <typename CharT>
+filter_result find_filtered_scalar(const CharT *hay, std::size_t n,
+                                   const CharT *needle, std::size_t m) noexcept
+{
+    const CharT *const end = hay + (n - m + 1UL);
+    std::size_t verified = 0UL;
+    std::size_t checks   = 0UL;
+
+    for (const CharT *it = hay; (it = std::find(it, end, needle[0])) != end; ++it)
+    {
+        const std::size_t j = static_cast<std::size_t>(it - hay);
+
+        ++checks;
+
+        if (same_chars(it, needle, m))
+        {
+            return {j, not_found, checks};
+        }
+
+        verified += m;
+
+        if (verified > verification_budget(j, m))
+        {
+            return {not_found, j + 1UL, checks};
+        }
+    }
+
+    return {not_found, not_found, checks};
+}
+
+template <typename CharT>
+filter_result rfind_filtered_scalar(const CharT *hay, std::size_t n,
+                                    const CharT *needle, std::size_t m) noexcept
+{
+    const std::size_t candidates = n - m + 1UL;
+    std::size_t verified = 0UL;
+    std::size_t checks   = 0UL;
+
+    for (std::size_t i = candidates; i-- > 0UL;)
+    {
+        if (hay[i] == needle[0])
+        {
+            ++checks;
+
+            if (same_chars(hay + i, needle, m))
+            {
+                return {i, not_found, checks};
+            }
+
+            verified += m;
+
+            if (verified > verification_budget(candidates - i - 1UL, m))
+            {
+                return {not_found, i, checks};
+            }
+        }
+    }
+
+    return {not_found, not_found, checks};
+}
+
+#endif
+
+}  // namespace
+
+
+template <typename CharT>
+std::size_t forward_search(const CharT *hay, std::size_t n,
+                           const CharT *needle, std::size_t m) noexcept
+{
+    if (m == 0UL)
+    {
+        return 0UL;
+    }
+
+    if (m > n)
+    {
+        return not_found;
+    }
+
+    filter_result r;
+
+#if defined(STRING_VIEW_SIMD_AVX2)
+    if (cpu_has_avx2())
+    {
+        r = find_filtered_avx2(hay, n, needle, m);
+    }
+    else
+#endif
+    {
+#if defined(STRING_VIEW_SIMD_SSE2)
+        r = find_filtered<sse2_ops>(hay, n, needle, m);
+#else
+        r = find_filtered_scalar(hay, n, needle, m);
+#endif
+    }
+
+    if (r.resume == not_found)
+    {
+        STRING_VIEW_VERIFIED(find, r.checks);
+        return r.position;
+    }
+
+    // The text keeps almost matching, finish the search in linear time
+    const std::size_t i = two_way(forward_sequence<CharT>{hay + r.resume}, static_cast<std::ptrdiff_t>(n - r.resume),
+                                  forward_sequence<CharT>{needle}, static_cast<std::ptrdiff_t>(m), r.checks);
+
+    STRING_VIEW_VERIFIED(find, r.checks);
+
+    return (i == not_found) ? not_found : (i + r.resume);
+}
+
+template <typename CharT>
+std::size_t backward_search(const CharT *hay, std::size_t n,
+                            const CharT *needle, std::size_t m) noexcept
+{
+    if (m == 0UL)
+    {
+        return n;
+    }
+
+    if (m > n)
+    {
+        return not_found;
+    }
+
+    filter_result r;
+
+#if defined(STRING_VIEW_SIMD_AVX2)
+    if (cpu_has_avx2())
+    {
+        r = rfind_filtered_avx2(hay, n, needle, m);
+    }
+    else
+#endif
+    {
+#if defined(STRING_VIEW_SIMD_SSE2)
+        r = rfind_filtered<sse2_ops>(hay, n, needle, m);
+#else
+        r = rfind_filtered_scalar(hay, n, needle, m);
+#endif
+    }
+
+    if (r.resume == not_found)
+    {
+        STRING_VIEW_VERIFIED(rfind, r.checks);
+        return r.position;
+    }
+
+    // Only the candidates before resume are left, they end before resume + m - 1
+    const std::size_t rest = r.resume + m - 1UL;
+
+    if (rest < m)
+    {
+        STRING_VIEW_VERIFIED(rfind, r.checks);
+        return not_found;
+    }
+
+    const std::size_t i = two_way(reverse_sequence<CharT>{hay + rest}, static_cast<std::ptrdiff_t>(rest),
+                                  reverse_sequence<CharT>{needle + m}, static_cast<std::ptrdiff_t>(m), r.checks);
+
+    STRING_VIEW_VERIFIED(rfind, r.checks);
+
+    return (i == not_found) ? not_found : (rest - m - i);
+}
+
+
+template std::size_t forward_search(const char *, std::size_t, const char *, std::size_t) noexcept;
+template std::size_t forward_search(const wchar_t *, std::size_t, const wchar_t *, std::size_t) noexcept;
+template std::size_t forward_search(const char16_t *, std::size_t, const char16_t *, std::size_t) noexcept;
+template std::size_t forward_search(const char32_t *, std::size_t, const char32_t *, std::size_t) noexcept;
+
+template std::size_t backward_search(const char *, std::size_t, const char *, std::size_t) noexcept;
+template std::size_t backward_search(const wchar_t *, std::size_t, const wchar_t *, std::size_t) noexcept;
+template std::size_t backward_search(const char16_t *, std::size_t, const char16_t *, std::size_t) noexcept;
+template std::size_t backward_search(const char32_t *, std::size_t, const char32_t *, std::size_t) noexcept;
+
+}  // namespace string_view_detail
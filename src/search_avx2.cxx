@@ -0,0 +1,33 @@
+#include "search_kernels.hxx"
+#include "simd_avx2.hxx"
+
+
+namespace string_view_detail
+{
+
+template <typename CharT>
+filter_result find_filtered_avx2(const CharT *hay, std::size_t n,
+                                 const CharT *needle, std::size_t m) noexcept
+{
+    return find_filtered<avx2_ops>(hay, n, needle, m);
+}
+
+template <typename CharT>
+filter_result rfind_filtered_avx2(const CharT *hay, std::size_t n,
+                                  const CharT *needle, std::size_t m) noexcept
+{
+    return rfind_filtered<avx2_ops>(hay, n, needle, m);
+}
+
+
+template filter_result find_filtered_avx2(const char *, std::size_t, const char *, std::size_t) noexcept;
+template filter_result find_filtered_avx2(const wchar_t *, std::size_t, const wchar_t *, std::size_t) noexcept;
+template filter_result find_filtered_avx2(const char16_t *, std::size_t, const char16_t *, std::size_t) noexcept;
+template filter_result find_filtered_avx2(const char32_t *, std::size_t, const char32_t *, std::size_t) noexcept;
+
+template filter_result rfind_filtered_avx2(const char *, std::size_t, const char *, std::size_t) noexcept;
+template filter_result rfind_filtered_avx2(const wchar_t *, std::size_t, const wchar_t *, std::size_t) noexcept;
+template filter_result rfind_filtered_avx2(const char16_t *, std::size_t, const char16_t *, std::size_t) noexcept;
+template filter_result rfind_filtered_avx2(const char32_t *, std::size_t, const char32_t *, std::size_t) noexcept;
+
+}  // namespace string_view_detail
@@ -0,0 +1,217 @@
+/***********************************************
+** @Copyright (C) 2018 - 2019 Mohammed ELomari.
+** @brief Vectorized first/last character filter behind the substring search.
+** \note  The kernels live in an anonymous namespace so every translation
+**        unit gets its own copy compiled for its own instruction set.
+************************************************/
+#ifndef STRING_VIEW_SEARCH_KERNELS_HXX
+#define STRING_VIEW_SEARCH_KERNELS_HXX
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "simd.hxx"
+
+
+namespace string_view_detail
+{
+
+/***
+* @brief Where a filtered search stopped
+* \note  The filter gives up once failed verifications have compared more
+*        characters than verification_budget allows, so a needle the text
+*        keeps almost matching can't make the search quadratic. resume is
+*        then the first candidate it did not rule out, npos otherwise.
+****/
+struct filter_result
+{
+    std::size_t position;  // the match, or npos
+    std::size_t resume;    // where Two-Way has to take over, or npos
+    std::size_t checks;    // candidates that passed the filter and were verified
+};
+
+/***
+* @brief Characters failed verifications may compare once \p scanned
+*        candidates are ruled out, keeping the filter linear in n + m
+****/
+inline constexpr std::size_t verification_budget(std::size_t scanned, std::size_t m) noexcept
+{
+    return (2UL * scanned) + (8UL * m);
+}
+
+/***
+* @brief AVX2 instances of the kernels below, built in search_avx2.cxx
+****/
+template <typename CharT>
+filter_result find_filtered_avx2(const CharT *hay, std::size_t n,
+                                 const CharT *needle, std::size_t m) noexcept;
+
+template <typename CharT>
+filter_result rfind_filtered_avx2(const CharT *hay, std::size_t n,
+                                  const CharT *needle, std::size_t m) noexcept;
+
+
+namespace
+{
+
+template <typename CharT>
+inline bool same_chars(const CharT *a, const CharT *b, std::size_t count) noexcept
+{
+    return std::memcmp(a, b, count * sizeof(CharT)) == 0;
+}
+
+/***
+* @brief Finds the first occurrence of \p needle in \p hay
+* \note  Requires 1 <= m <= n. Each block compares the needle's first and
+*        last characters against all the candidate positions at once and
+*        only verifies the middle of the needle on a double hit.
+* @return the position of the match, or where the filter gave up
+****/
+template <typename Ops, typename CharT>
+filter_result find_filtered(const CharT *hay, std::size_t n,
+                            const CharT *needle, std::size_t m) noexcept
+{
+    constexpr std::size_t lanes = Ops::width / sizeof(CharT);
+
+    const std::size_t candidates = n - m + 1UL;
+    const auto first = Ops::template splat<CharT>(needle[0]);
+    const auto last  = Ops::template splat<CharT>(needle[m - 1UL]);
+
+    std::size_t i = 0UL;
+    std::size_t verified = 0UL;  // characters compared by failed verifications
+    std::size_t checks   = 0UL;
+
+    for (; i + lanes <= candidates; i += lanes)
+    {
+        auto hits = Ops::template cmpeq<CharT>(Ops::load(hay + i), first);
+
+        if (m > 1UL)
+        {
+            hits = Ops::bit_and(hits, Ops::template cmpeq<CharT>(
+                                          Ops::load(hay + i + m - 1UL), last));
+        }
+
+        std::uint32_t mask = Ops::mask(hits);
+
+        while (mask != 0U)
+        {
+            const unsigned bit  = lowest_bit(mask);
+            const std::size_t j = i + (bit / sizeof(CharT));
+
+            ++checks;
+
+            if (m <= 2UL || same_chars(hay + j + 1UL, needle + 1UL, m - 2UL))
+            {
+                return {j, std::size_t(-1L), checks};
+            }
+
+            verified += m;
+
+            if (verified > verification_budget(j, m))
+            {
+                return {std::size_t(-1L), j + 1UL, checks};
+            }
+
+            mask &= ~(element_mask<CharT> << bit);
+        }
+    }
+
+    for (; i < candidates; ++i)
+    {
+        if (hay[i] == needle[0])
+        {
+            ++checks;
+
+            if (same_chars(hay + i, needle, m))
+            {
+                return {i, std::size_t(-1L), checks};
+            }
+        }
+    }
+
+    return {std::size_t(-1L), std::size_t(-1L), checks};
+}
+
+/***
+* @brief Finds the last occurrence of \p needle in \p hay
+* \note  Requires 1 <= m <= n. Mirror image of find_filtered: when it
+*        gives up, the candidates from resume on are ruled out.
+* @return the position of the match, or where the filter gave up
+****/
+template <typename Ops, typename CharT>
+filter_result rfind_filtered(const CharT *hay, std::size_t n,
+                             const CharT *needle, std::size_t m) noexcept
+{
+    constexpr std::size_t lanes = Ops::width / sizeof(CharT);
+
+    const auto first = Ops::template splat<CharT>(needle[0]);
+    const auto last  = Ops::template splat<CharT>(needle[m - 1UL]);
+
+    const std::size_t candidates = n - m + 1UL;
+
+    std::size_t i = candidates;  // one past the last candidate
+    std::size_t verified = 0UL;  // characters compared by failed verifications
+    std::size_t checks   = 0UL;
+
+    while (i >= lanes)
+    {
+        const std::size_t block = i - lanes;
+
+        auto hits = Ops::template cmpeq<CharT>(Ops::load(hay + block), first);
+
+        if (m > 1UL)
+        {
+            hits = Ops::bit_and(hits, Ops::template cmpeq<CharT>(
+                                          Ops::load(hay + block + m - 1UL), last));
+        }
+
+        std::uint32_t mask = Ops::mask(hits);
+
+        while (mask != 0U)
+        {
+            const unsigned bit  = highest_bit(mask) & ~unsigned(sizeof(CharT) - 1UL);
+            const std::size_t j = block + (bit / sizeof(CharT));
+
+            ++checks;
+
+            if (m <= 2UL || same_chars(hay + j + 1UL, needle + 1UL, m - 2UL))
+            {
+                return {j, std::size_t(-1L), checks};
+            }
+
+            verified += m;
+
+            if (verified > verification_budget(candidates - j - 1UL, m))
+            {
+                return {std::size_t(-1L), j, checks};
+            }
+
+            mask &= ~(element_mask<CharT> << bit);
+        }
+
+        i = block;
+    }
+
+    while (i-- > 0UL)
+    {
+        if (hay[i] == needle[0])
+        {
+            ++checks;
+
+            if (same_chars(hay + i, needle, m))
+            {
+                return {i, std::size_t(-1L), checks};
+            }
+        }
+    }
+
+    return {std::size_t(-1L), std::size_t(-1L), checks};
+}
+
+}  // namespace
+
+}  // namespace string_view_detail
+
+#endif
@@ -0,0 +1,17 @@
+#include "simd.hxx"
+
+
+namespace string_view_detail
+{
+
+bool cpu_has_avx2() noexcept
+{
+#if defined(STRING_VIEW_SIMD_AVX2) && (defined(__GNUC__) || defined(__clang__))
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+}  // namespace string_view_detail
@@ -0,0 +1,121 @@
+/***********************************************
+** @Copyright (C) 2018 - 2019 Mohammed ELomari.
+** @brief Internal SIMD helpers shared by the library kernels.
+************************************************/
+#ifndef STRING_VIEW_SIMD_HXX
+#define STRING_VIEW_SIMD_HXX
+
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define STRING_VIEW_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+
+namespace string_view_detail
+{
+
+/***
+* @brief Tells whether the running CPU (and OS) supports AVX2
+* \note  The result is computed once and cached.
+* @return true if the AVX2 kernels may be used
+****/
+bool cpu_has_avx2() noexcept;
+
+
+/***
+* @brief Number of trailing zero bits of a non-zero mask
+****/
+inline unsigned lowest_bit(std::uint32_t mask) noexcept
+{
+    return static_cast<unsigned>(std::countr_zero(mask));
+}
+
+/***
+* @brief Index of the highest set bit of a non-zero mask
+****/
+inline unsigned highest_bit(std::uint32_t mask) noexcept
+{
+    return 31U - static_cast<unsigned>(std::countl_zero(mask));
+}
+
+/***
+* @brief Mask covering all the bytes of one element of type \p CharT
+****/
+template <typename CharT>
+inline constexpr std::uint32_t element_mask = (1U << sizeof(CharT)) - 1U;
+
+
+namespace
+{
+
+#if defined(STRING_VIEW_SIMD_SSE2)
+
+/***
+* @brief 128-bit vector operations, available on every x86-64 CPU
+****/
+struct sse2_ops
+{
+    using vector = __m128i;
+
+    static constexpr std::size_t width = 16UL;
+
+    static vector load(const void *p) noexcept
+    {
+        return _mm_loadu_si128(static_cast<const __m128i *>(p));
+    }
+
+    template <typename CharT>
+    static vector splat(CharT c) noexcept
+    {
+        if constexpr (sizeof(CharT) == 1UL) {
+            return _mm_set1_epi8(static_cast<char>(c));
+        }
+        else if constexpr (sizeof(CharT) == 2UL) {
+            return _mm_set1_epi16(static_cast<short>(c));
+        }
+        else {
+            return _mm_set1_epi32(static_cast<int>(c));
+        }
+    }
+
+    template <typename CharT>
+    static vector cmpeq(vector a, vector b) noexcept
+    {
+        if constexpr (sizeof(CharT) == 1UL) {
+            return _mm_cmpeq_epi8(a, b);
+        }
+        else if constexpr (sizeof(CharT) == 2UL) {
+            return _mm_cmpeq_epi16(a, b);
+        }
+        else {
+            return _mm_cmpeq_epi32(a, b);
+        }
+    }
+
+    static vector bit_and(vector a, vector b) noexcept { return _mm_and_si128(a, b); }
+
+    static vector bit_or(vector a, vector b) noexcept { return _mm_or_si128(a, b); }
+
+    static vector add_bytes(vector a, vector b) noexcept { return _mm_add_epi8(a, b); }
+
+    // Signed byte comparison, all ones where a < b
+    static vector less_bytes(vector a, vector b) noexcept { return _mm_cmplt_epi8(a, b); }
+
+    static std::uint32_t mask(vector v) noexcept
+    {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(v));
+    }
+};
+
+#endif
+
+}  // namespace
+
+}  // namespace string_view_detail
+
+#endif
@@ -0,0 +1,82 @@
+/***********************************************
+** @Copyright (C) 2018 - 2019 Mohammed ELomari.
+** @brief Internal AVX2 vector operations.
+** \note  Only include from translation units built with -mavx2.
+************************************************/
+#ifndef STRING_VIEW_SIMD_AVX2_HXX
+#define STRING_VIEW_SIMD_AVX2_HXX
+
+
+#include <immintrin.h>
+
+#include "simd.hxx"
+
+
+namespace string_view_detail
+{
+
+namespace
+{
+
+/***
+* @brief 256-bit vector operations, selected at runtime by cpu_has_avx2
+****/
+struct avx2_ops
+{
+    using vector = __m256i;
+
+    static constexpr std::size_t width = 32UL;
+
+    static vector load(const void *p) noexcept
+    {
+        return _mm256_loadu_si256(static_cast<const __m256i *>(p));
+    }
+
+    template <typename CharT>
+    static vector splat(CharT c) noexcept
+    {
+        if constexpr (sizeof(CharT) == 1UL) {
+            return _mm256_set1_epi8(static_cast<char>(c));
+        }
+        else if constexpr (sizeof(CharT) == 2UL) {
+            return _mm256_set1_epi16(static_cast<short>(c));
+        }
+        else {
+            return _mm256_set1_epi32(static_cast<int>(c));
+        }
+    }
+
+    template <typename CharT>
+    static vector cmpeq(vector a, vector b) noexcept
+    {
+        if constexpr (sizeof(CharT) == 1UL) {
+            return _mm256_cmpeq_epi8(a, b);
+        }
+        else if constexpr (sizeof(CharT) == 2UL) {
+            return _mm256_cmpeq_epi16(a, b);
+        }
+        else {
+            return _mm256_cmpeq_epi32(a, b);
+        }
+    }
+
+    static vector bit_and(vector a, vector b) noexcept { return _mm256_and_si256(a, b); }
+
+    static vector bit_or(vector a, vector b) noexcept { return _mm256_or_si256(a, b); }
+
+    static vector add_bytes(vector a, vector b) noexcept { return _mm256_add_epi8(a, b); }
+
+    // Signed byte comparison, all ones where a < b
+    static vector less_bytes(vector a, vector b) noexcept { return _mm256_cmpgt_epi8(b, a); }
+
+    static std::uint32_t mask(vector v) noexcept
+    {
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(v));
+    }
+};
+
+}  // namespace
+
+}  // namespace string_view_detail
+
+#endif
@@ -1,4 +1,5 @@
 #include <string_view.hxx>
+#include <unicode.hxx>
 
 
 /**
@@ -14,13 +15,47 @@ template class basic_string_view<char32_t>;
 template auto operator<<(std::basic_ostream<char>&, const string_view&)
     -> std::basic_ostream<char>&;
 
-template auto operator<<(std::basic_ostream<char>&, const wstring_view&)
+template auto operator<<(std::basic_ostream<wchar_t>&, const wstring_view&)
     -> std::basic_ostream<wchar_t>&;
 
-template auto operator<<(std::basic_ostream<char>&,
-                                const u16string_view&)
-    -> std::basic_ostream<char>&;
 
-template auto operator<<(std::basic_ostream<char>&,
-                                const u32string_view&)
-    -> std::basic_ostream<char>&;
\ No newline at end of file
+namespace
+{
+
+/***
+* @brief Writes the UTF-8 form of \p str through a fixed buffer
+****/
+template <typename View>
+std::basic_ostream<char> &write_utf8(std::basic_ostream<char> &_output, View _str)
+{
+    char buffer[1024];
+
+    while (!_str.empty() && _output)
+    {
+        const utf_result result = to_utf8(_str, buffer, sizeof(buffer));
+
+        _output.write(buffer, static_cast<std::streamsize>(result.written));
+        _str.remove_prefix(result.read);
+
+        if ((result.status == utf_status::invalid) || (result.status == utf_status::incomplete))
+        {
+            _output.write("\xEF\xBF\xBD", 3);
+            _str.remove_prefix(1UL);
+        }
+    }
+
+    return _output;
+}
+
+}  // namespace
+
+
+auto operator<<(std::basic_ostream<char> &_output, const u16string_view &_str) -> std::basic_ostream<char> &
+{
+    return write_utf8(_output, _str);
+}
+
+auto operator<<(std::basic_ostream<char> &_output, const u32string_view &_str) -> std::basic_ostream<char> &
+{
+    return write_utf8(_output, _str);
+}
@@ -0,0 +1,144 @@
+#include <thread_pool.hxx>
+
+
+namespace
+{
+
+// Index of the worker running on this thread, and the pool it belongs to
+thread_local const thread_pool *current_pool = nullptr;
+thread_local std::size_t current_worker      = 0UL;
+
+}  // namespace
+
+
+thread_pool::thread_pool(size_type threads)
+{
+    threads = std::max<size_type>(threads, 1UL);
+
+    for (size_type i = 0UL; i < threads; ++i)
+    {
+        this->m_workers.push_back(std::make_unique<worker>());
+    }
+
+    try
+    {
+        for (size_type i = 0UL; i < threads; ++i)
+        {
+            this->m_workers[i]->thread = std::thread([this, i] { this->run(i); });
+        }
+    }
+    catch (...)
+    {
+        // The destructor will not run, join the workers already started
+        this->stop();
+        throw;
+    }
+}
+
+thread_pool::~thread_pool()
+{
+    this->stop();
+}
+
+void thread_pool::submit(task_type task)
+{
+    const size_type index = (current_pool == this)
+                                ? current_worker
+                                : (this->m_next.fetch_add(1UL, std::memory_order_relaxed) % this->size());
+
+    {
+        std::lock_guard<std::mutex> lock(this->m_mutex);
+        this->m_pending.fetch_add(1UL);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->m_workers[index]->mutex);
+        this->m_workers[index]->queue.push_back(std::move(task));
+    }
+
+    this->m_wake.notify_one();
+}
+
+thread_pool &thread_pool::default_pool()
+{
+    static thread_pool pool;
+    return pool;
+}
+
+bool thread_pool::pop(size_type index, task_type &task)
+{
+    // Own queue first, newest task first
+    {
+        worker &self = *this->m_workers[index];
+        std::lock_guard<std::mutex> lock(self.mutex);
+
+        if (!self.queue.empty())
+        {
+            task = std::move(self.queue.back());
+            self.queue.pop_back();
+            return true;
+        }
+    }
+
+    // Then steal the oldest task of the others
+    for (size_type k = 1UL; k < this->size(); ++k)
+    {
+        worker &victim = *this->m_workers[(index + k) % this->size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+
+        if (!victim.queue.empty())
+        {
+            task = std::move(victim.queue.front());
+            victim.queue.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void thread_pool::run(size_type index)
+{
+    current_pool   = this;
+    current_worker = index;
+
+    task_type task;
+
+    for (;;)
+    {
+        if (this->pop(index, task))
+        {
+            this->m_pending.fetch_sub(1UL);
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(this->m_mutex);
+
+        this->m_wake.wait(lock, [this] { return this->m_stop || (this->m_pending.load() != 0UL); });
+
+        if (this->m_stop && (this->m_pending.load() == 0UL))
+        {
+            return;
+        }
+    }
+}
+
+void thread_pool::stop() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(this->m_mutex);
+        this->m_stop = true;
+    }
+
+    this->m_wake.notify_all();
+
+    for (auto &w : this->m_workers)
+    {
+        if (w->thread.joinable())
+        {
+            w->thread.join();
+        }
+    }
+}
@@ -0,0 +1,198 @@
+/***********************************************
+** @Copyright (C) 2018 - 2019 Mohammed ELomari.
+** @brief Crochemore-Perrin Two-Way search, the linear fallback of the
+**        filtered substring searches.
+** \note  Works on any sequence whose elements compare with == and <, so
+**        the case-insensitive search runs it over folded characters.
+************************************************/
+#ifndef STRING_VIEW_TWO_WAY_HXX
+#define STRING_VIEW_TWO_WAY_HXX
+
+
+#include <algorithm>
+#include <cstddef>
+
+
+namespace string_view_detail
+{
+
+namespace
+{
+
+/***
+* @brief Reads a character sequence front to back
+****/
+template <typename CharT>
+struct forward_sequence
+{
+    const CharT *first;
+
+    CharT operator[](std::ptrdiff_t i) const noexcept { return this->first[i]; }
+};
+
+/***
+* @brief Reads a character sequence back to front, so the forward
+*        Two-Way search doubles as a backward one.
+****/
+template <typename CharT>
+struct reverse_sequence
+{
+    const CharT *last;  // one past the final character
+
+    CharT operator[](std::ptrdiff_t i) const noexcept { return this->last[-1 - i]; }
+};
+
+
+/***
+* @brief Computes the maximal suffix of \p x for one of the two orderings
+* @param x        the needle
+* @param m        the length of the needle
+* @param period   receives the period of the maximal suffix
+* @param inverted whether to use the inverted character ordering
+* @return the position right before the maximal suffix
+****/
+template <typename Sequence>
+std::ptrdiff_t maximal_suffix(Sequence x, std::ptrdiff_t m,
+                              std::ptrdiff_t &period, bool inverted) noexcept
+{
+    std::ptrdiff_t ms = -1;
+    std::ptrdiff_t j  = 0;
+    std::ptrdiff_t k  = 1;
+    std::ptrdiff_t p  = 1;
+
+    while (j + k < m)
+    {
+        const auto a = x[j + k];
+        const auto b = x[ms + k];
+
+        if (inverted ? (b < a) : (a < b))
+        {
+            j += k;
+            k = 1;
+            p = j - ms;
+        }
+        else if (a == b)
+        {
+            if (k != p)
+            {
+                ++k;
+            }
+            else
+            {
+                j += p;
+                k = 1;
+            }
+        }
+        else
+        {
+            ms = j;
+            j  = ms + 1;
+            k = p = 1;
+        }
+    }
+
+    period = p;
+    return ms;
+}
+
+/***
+* @brief Crochemore-Perrin Two-Way string matching
+* \note  Linear time and constant space whatever the needle looks like,
+*        which keeps long, self-similar needles from going quadratic.
+* @param  checks  incremented once per alignment compared to the needle
+* @return the position of the first match, or npos
+****/
+template <typename Sequence>
+std::size_t two_way(Sequence y, std::ptrdiff_t n, Sequence x, std::ptrdiff_t m, std::size_t &checks) noexcept
+{
+    std::ptrdiff_t p = 0;
+    std::ptrdiff_t q = 0;
+
+    const std::ptrdiff_t i = maximal_suffix(x, m, p, false);
+    const std::ptrdiff_t j = maximal_suffix(x, m, q, true);
+
+    const std::ptrdiff_t ell = (i > j) ? i : j;
+    std::ptrdiff_t per       = (i > j) ? p : q;
+
+    bool periodic = (ell + 1 + per) <= m;
+
+    for (std::ptrdiff_t k = 0; periodic && k <= ell; ++k)
+    {
+        periodic = (x[k] == x[k + per]);
+    }
+
+    std::ptrdiff_t pos = 0;
+
+    if (periodic)
+    {
+        std::ptrdiff_t memory = -1;
+
+        while (pos <= n - m)
+        {
+            std::ptrdiff_t k = std::max(ell, memory) + 1;
+
+            ++checks;
+
+            while (k < m && x[k] == y[k + pos]) ++k;
+
+            if (k >= m)
+            {
+                k = ell;
+
+                while (k > memory && x[k] == y[k + pos]) --k;
+
+                if (k <= memory)
+                {
+                    return static_cast<std::size_t>(pos);
+                }
+
+                pos += per;
+                memory = m - per - 1;
+            }
+            else
+            {
+                pos += k - ell;
+                memory = -1;
+            }
+        }
+    }
+    else
+    {
+        per = std::max(ell + 1, m - ell - 1) + 1;
+
+        while (pos <= n - m)
+        {
+            std::ptrdiff_t k = ell + 1;
+
+            ++checks;
+
+            while (k < m && x[k] == y[k + pos]) ++k;
+
+            if (k >= m)
+            {
+                k = ell;
+
+                while (k >= 0 && x[k] == y[k + pos]) --k;
+
+                if (k < 0)
+                {
+                    return static_cast<std::size_t>(pos);
+                }
+
+                pos += per;
+            }
+            else
+            {
+                pos += k - ell;
+            }
+        }
+    }
+
+    return std::size_t(-1L);
+}
+
+}  // namespace
+
+}  // namespace string_view_detail
+
+#endif
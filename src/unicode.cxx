@@ -0,0 +1,640 @@
+#include <unicode.hxx>
+
+#include <algorithm>
+#include <cstdint>
+
+#include "simd.hxx"
+#include "unicode_kernels.hxx"
+
+
+namespace
+{
+
+/***
+* @brief One code point read off the input
+****/
+struct code_point
+{
+    char32_t value;
+    std::size_t length;  // code units read, or up to the error
+    utf_status status;
+};
+
+inline bool is_surrogate(char32_t c) noexcept
+{
+    return (c & 0xFFFFF800U) == 0xD800U;
+}
+
+
+// Decoders
+
+code_point decode(const char *s, std::size_t n) noexcept
+{
+    const auto *p = reinterpret_cast<const unsigned char *>(s);
+    const char32_t lead = p[0];
+
+    if (lead < 0x80U)
+    {
+        return {lead, 1UL, utf_status::ok};
+    }
+
+    // The well-formed byte sequences of the Unicode standard: the lead
+    // bounds the second byte, which rules out overlong forms, surrogates
+    // and values past U+10FFFF before the sequence is complete. A prefix
+    // is only incomplete if some ending makes it valid.
+    std::size_t length;
+    char32_t value;
+    unsigned least = 0x80U;  // range of the second byte
+    unsigned most  = 0xBFU;
+
+    if ((lead >= 0xC2U) && (lead <= 0xDFU))
+    {
+        length = 2UL, value = lead & 0x1FU;
+    }
+    else if ((lead >= 0xE0U) && (lead <= 0xEFU))
+    {
+        length = 3UL, value = lead & 0x0FU;
+        least  = (lead == 0xE0U) ? 0xA0U : least;
+        most   = (lead == 0xEDU) ? 0x9FU : most;
+    }
+    else if ((lead >= 0xF0U) && (lead <= 0xF4U))
+    {
+        length = 4UL, value = lead & 0x07U;
+        least  = (lead == 0xF0U) ? 0x90U : least;
+        most   = (lead == 0xF4U) ? 0x8FU : most;
+    }
+    else
+    {
+        return {0U, 1UL, utf_status::invalid};
+    }
+
+    for (std::size_t k = 1UL; k < length; ++k)
+    {
+        if (k == n)
+        {
+            return {0U, k, utf_status::incomplete};
+        }
+
+        if ((p[k] < least) || (p[k] > most))
+        {
+            return {0U, k, utf_status::invalid};
+        }
+
+        value = (value << 6U) | (p[k] & 0x3FU);
+        least = 0x80U, most = 0xBFU;
+    }
+
+    return {value, length, utf_status::ok};
+}
+
+code_point decode(const char16_t *p, std::size_t n) noexcept
+{
+    const char32_t high = p[0];
+
+    if (!is_surrogate(high))
+    {
+        return {high, 1UL, utf_status::ok};
+    }
+
+    if (high >= 0xDC00U)
+    {
+        return {0U, 1UL, utf_status::invalid};
+    }
+
+    if (n == 1UL)
+    {
+        return {0U, 1UL, utf_status::incomplete};
+    }
+
+    const char32_t low = p[1];
+
+    if ((low < 0xDC00U) || (low > 0xDFFFU))
+    {
+        return {0U, 1UL, utf_status::invalid};
+    }
+
+    return {0x10000U + ((high - 0xD800U) << 10U) + (low - 0xDC00U), 2UL, utf_status::ok};
+}
+
+code_point decode(const char32_t *p, std::size_t) noexcept
+{
+    if ((p[0] > 0x10FFFFU) || is_surrogate(p[0]))
+    {
+        return {0U, 1UL, utf_status::invalid};
+    }
+
+    return {p[0], 1UL, utf_status::ok};
+}
+
+
+// Encoders
+
+template <typename CharT>
+std::size_t encoded_length(char32_t c) noexcept
+{
+    if constexpr (sizeof(CharT) == 1UL) {
+        return (c < 0x80U) ? 1UL : (c < 0x800U) ? 2UL : (c < 0x10000U) ? 3UL : 4UL;
+    }
+    else if constexpr (sizeof(CharT) == 2UL) {
+        return (c < 0x10000U) ? 1UL : 2UL;
+    }
+    else {
+        return 1UL;
+    }
+}
+
+void encode(char32_t c, char *out) noexcept
+{
+    if (c < 0x80U)
+    {
+        out[0] = static_cast<char>(c);
+    }
+    else if (c < 0x800U)
+    {
+        out[0] = static_cast<char>(0xC0U | (c >> 6U));
+        out[1] = static_cast<char>(0x80U | (c & 0x3FU));
+    }
+    else if (c < 0x10000U)
+    {
+        out[0] = static_cast<char>(0xE0U | (c >> 12U));
+        out[1] = static_cast<char>(0x80U | ((c >> 6U) & 0x3FU));
+        out[2] = static_cast<char>(0x80U | (c & 0x3FU));
+    }
+    else
+    {
+        out[0] = static_cast<char>(0xF0U | (c >> 18U));
+        out[1] = static_cast<char>(0x80U | ((c >> 12U) & 0x3FU));
+        out[2] = static_cast<char>(0x80U | ((c >> 6U) & 0x3FU));
+        out[3] = static_cast<char>(0x80U | (c & 0x3FU));
+    }
+}
+
+void encode(char32_t c, char16_t *out) noexcept
+{
+    if (c < 0x10000U)
+    {
+        out[0] = static_cast<char16_t>(c);
+    }
+    else
+    {
+        out[0] = static_cast<char16_t>(0xD800U + ((c - 0x10000U) >> 10U));
+        out[1] = static_cast<char16_t>(0xDC00U + ((c - 0x10000U) & 0x3FFU));
+    }
+}
+
+void encode(char32_t c, char32_t *out) noexcept
+{
+    out[0] = c;
+}
+
+
+// Bulk paths
+//
+// Each one converts, a vector at a time, the run of code units at the
+// front of in + i that map one to one onto the output, then stops at the
+// first vector that holds anything else.
+
+#if defined(STRING_VIEW_SIMD_SSE2)
+
+inline __m128i load(const void *p) noexcept
+{
+    return _mm_loadu_si128(static_cast<const __m128i *>(p));
+}
+
+inline void store(void *p, __m128i v) noexcept
+{
+    _mm_storeu_si128(static_cast<__m128i *>(p), v);
+}
+
+inline bool all_zero(__m128i v) noexcept
+{
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())) == 0xFFFF;
+}
+
+// Nonzero lanes flag UTF-16 units in the surrogate range
+inline __m128i surrogates16(__m128i v) noexcept
+{
+    return _mm_cmpeq_epi16(_mm_and_si128(v, _mm_set1_epi16(static_cast<short>(0xF800))),
+                           _mm_set1_epi16(static_cast<short>(0xD800)));
+}
+
+// Nonzero lanes flag UTF-32 units in the surrogate range
+inline __m128i surrogates32(__m128i v) noexcept
+{
+    return _mm_cmpeq_epi32(_mm_and_si128(v, _mm_set1_epi32(static_cast<int>(0xFFFFF800U))),
+                           _mm_set1_epi32(0xD800));
+}
+
+void bulk(const char *in, std::size_t n, char16_t *out, std::size_t capacity,
+          std::size_t &i, std::size_t &o) noexcept
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; ((n - i) >= 16UL) && ((capacity - o) >= 16UL); i += 16UL, o += 16UL)
+    {
+        const __m128i v = load(in + i);
+
+        if (_mm_movemask_epi8(v) != 0)
+        {
+            break;
+        }
+
+        store(out + o, _mm_unpacklo_epi8(v, zero));
+        store(out + o + 8UL, _mm_unpackhi_epi8(v, zero));
+    }
+}
+
+void bulk(const char *in, std::size_t n, char32_t *out, std::size_t capacity,
+          std::size_t &i, std::size_t &o) noexcept
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; ((n - i) >= 16UL) && ((capacity - o) >= 16UL); i += 16UL, o += 16UL)
+    {
+        const __m128i v = load(in + i);
+
+        if (_mm_movemask_epi8(v) != 0)
+        {
+            break;
+        }
+
+        const __m128i lo = _mm_unpacklo_epi8(v, zero);
+        const __m128i hi = _mm_unpackhi_epi8(v, zero);
+
+        store(out + o, _mm_unpacklo_epi16(lo, zero));
+        store(out + o + 4UL, _mm_unpackhi_epi16(lo, zero));
+        store(out + o + 8UL, _mm_unpacklo_epi16(hi, zero));
+        store(out + o + 12UL, _mm_unpackhi_epi16(hi, zero));
+    }
+}
+
+void bulk(const char16_t *in, std::size_t n, char *out, std::size_t capacity,
+          std::size_t &i, std::size_t &o) noexcept
+{
+    const __m128i non_ascii = _mm_set1_epi16(static_cast<short>(0xFF80));
+
+    for (; ((n - i) >= 16UL) && ((capacity - o) >= 16UL); i += 16UL, o += 16UL)
+    {
+        const __m128i a = load(in + i);
+        const __m128i b = load(in + i + 8UL);
+
+        if (!all_zero(_mm_and_si128(_mm_or_si128(a, b), non_ascii)))
+        {
+            break;
+        }
+
+        store(out + o, _mm_packus_epi16(a, b));
+    }
+}
+
+void bulk(const char16_t *in, std::size_t n, char32_t *out, std::size_t capacity,
+          std::size_t &i, std::size_t &o) noexcept
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; ((n - i) >= 8UL) && ((capacity - o) >= 8UL); i += 8UL, o += 8UL)
+    {
+        const __m128i v = load(in + i);
+
+        if (_mm_movemask_epi8(surrogates16(v)) != 0)
+        {
+            break;
+        }
+
+        store(out + o, _mm_unpacklo_epi16(v, zero));
+        store(out + o + 4UL, _mm_unpackhi_epi16(v, zero));
+    }
+}
+
+void bulk(const char32_t *in, std::size_t n, char *out, std::size_t capacity,
+          std::size_t &i, std::size_t &o) noexcept
+{
+    const __m128i non_ascii = _mm_set1_epi32(static_cast<int>(0xFFFFFF80U));
+
+    for (; ((n - i) >= 16UL) && ((capacity - o) >= 16UL); i += 16UL, o += 16UL)
+    {
+        const __m128i a = load(in + i);
+        const __m128i b = load(in + i + 4UL);
+        const __m128i c = load(in + i + 8UL);
+        const __m128i d = load(in + i + 12UL);
+
+        if (!all_zero(_mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), non_ascii)))
+        {
+            break;
+        }
+
+        store(out + o, _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+    }
+}
+
+void bulk(const char32_t *in, std::size_t n, char16_t *out, std::size_t capacity,
+          std::size_t &i, std::size_t &o) noexcept
+{
+    const __m128i beyond_bmp = _mm_set1_epi32(static_cast<int>(0xFFFF0000U));
+    const __m128i bias32     = _mm_set1_epi32(0x8000);
+    const __m128i bias16     = _mm_set1_epi16(static_cast<short>(0x8000));
+
+    for (; ((n - i) >= 8UL) && ((capacity - o) >= 8UL); i += 8UL, o += 8UL)
+    {
+        const __m128i a = load(in + i);
+        const __m128i b = load(in + i + 4UL);
+
+        if (!all_zero(_mm_and_si128(_mm_or_si128(a, b), beyond_bmp)) ||
+            (_mm_movemask_epi8(_mm_or_si128(surrogates32(a), surrogates32(b))) != 0))
+        {
+            break;
+        }
+
+        // SSE2 only packs with signed saturation, so shift the values
+        // into the signed 16-bit range and back
+        const __m128i packed = _mm_packs_epi32(_mm_sub_epi32(a, bias32), _mm_sub_epi32(b, bias32));
+
+        store(out + o, _mm_xor_si128(packed, bias16));
+    }
+}
+
+#else
+
+template <typename From, typename To>
+void bulk(const From *, std::size_t, To *, std::size_t, std::size_t &, std::size_t &) noexcept
+{
+}
+
+#endif
+
+
+/***
+* @brief Converts code points until the input ends, an error is met or
+*        the output is full
+* \note  Whenever the bulk path stops, one vector worth of input goes
+*        through the scalar path before it is tried again.
+****/
+template <typename From, typename To>
+utf_result transcode(const From *in, std::size_t n, To *out, std::size_t capacity) noexcept
+{
+    constexpr std::size_t block = 16UL / sizeof(From);
+
+    std::size_t i = 0UL;
+    std::size_t o = 0UL;
+
+    while (i < n)
+    {
+        bulk(in, n, out, capacity, i, o);
+
+        for (const std::size_t stop = std::min(n, i + block); i < stop;)
+        {
+            const code_point c = decode(in + i, n - i);
+
+            if (c.status != utf_status::ok)
+            {
+                return {c.status, i, o};
+            }
+
+            const std::size_t length = encoded_length<To>(c.value);
+
+            if ((capacity - o) < length)
+            {
+                return {utf_status::output_full, i, o};
+            }
+
+            encode(c.value, out + o);
+            i += c.length;
+            o += length;
+        }
+    }
+
+    return {utf_status::ok, i, o};
+}
+
+
+// Validation
+
+/***
+* @brief Skips the leading code units that are valid on their own
+****/
+std::size_t skip_simple(const char *s, std::size_t n) noexcept
+{
+    std::size_t i = 0UL;
+
+#if defined(STRING_VIEW_SIMD_SSE2)
+    while (((n - i) >= 16UL) && (_mm_movemask_epi8(load(s + i)) == 0))
+    {
+        i += 16UL;
+    }
+#else
+    static_cast<void>(s);
+    static_cast<void>(n);
+#endif
+
+    return i;
+}
+
+std::size_t skip_simple(const char16_t *s, std::size_t n) noexcept
+{
+    std::size_t i = 0UL;
+
+#if defined(STRING_VIEW_SIMD_SSE2)
+    while (((n - i) >= 8UL) && (_mm_movemask_epi8(surrogates16(load(s + i))) == 0))
+    {
+        i += 8UL;
+    }
+#else
+    static_cast<void>(s);
+    static_cast<void>(n);
+#endif
+
+    return i;
+}
+
+std::size_t skip_simple(const char32_t *s, std::size_t n) noexcept
+{
+    std::size_t i = 0UL;
+
+#if defined(STRING_VIEW_SIMD_SSE2)
+    // Values past U+10FFFF, compared unsigned through a bias
+    const __m128i bias  = _mm_set1_epi32(static_cast<int>(0x80000000U));
+    const __m128i limit = _mm_set1_epi32(static_cast<int>(0x8010FFFFU));
+
+    for (; (n - i) >= 4UL; i += 4UL)
+    {
+        const __m128i v = load(s + i);
+        const __m128i too_large = _mm_cmpgt_epi32(_mm_xor_si128(v, bias), limit);
+
+        if (_mm_movemask_epi8(_mm_or_si128(too_large, surrogates32(v))) != 0)
+        {
+            break;
+        }
+    }
+#else
+    static_cast<void>(s);
+    static_cast<void>(n);
+#endif
+
+    return i;
+}
+
+template <typename CharT>
+bool validate(const CharT *s, std::size_t n) noexcept
+{
+    constexpr std::size_t block = 16UL / sizeof(CharT);
+
+    std::size_t i = 0UL;
+
+    while (i < n)
+    {
+        i += skip_simple(s + i, n - i);
+
+        for (const std::size_t stop = std::min(n, i + block); i < stop;)
+        {
+            const code_point c = decode(s + i, n - i);
+
+            if (c.status != utf_status::ok)
+            {
+                return false;
+            }
+
+            i += c.length;
+        }
+    }
+
+    return true;
+}
+
+}  // namespace
+
+
+// Validation
+
+bool is_valid_utf8(string_view str) noexcept
+{
+#if defined(STRING_VIEW_SIMD_AVX2)
+    if (string_view_detail::cpu_has_avx2())
+    {
+        return string_view_detail::is_valid_utf8_avx2(str.data(), str.size());
+    }
+#endif
+
+    return validate(str.data(), str.size());
+}
+
+bool is_valid_utf16(u16string_view str) noexcept
+{
+    return validate(str.data(), str.size());
+}
+
+bool is_valid_utf32(u32string_view str) noexcept
+{
+    return validate(str.data(), str.size());
+}
+
+
+// Lengths
+
+std::size_t utf8_length(u16string_view str) noexcept
+{
+    std::size_t length = 0UL;
+
+    for (const char16_t c : str)
+    {
+        // Each half of a surrogate pair counts for two of its four bytes
+        length += (c < 0x80U) ? 1UL : ((c < 0x800U) || is_surrogate(c)) ? 2UL : 3UL;
+    }
+
+    return length;
+}
+
+std::size_t utf8_length(u32string_view str) noexcept
+{
+    std::size_t length = 0UL;
+
+    for (const char32_t c : str)
+    {
+        length += encoded_length<char>(c);
+    }
+
+    return length;
+}
+
+std::size_t utf16_length(string_view str) noexcept
+{
+    std::size_t length = 0UL;
+
+    for (const char c : str)
+    {
+        const auto u = static_cast<unsigned char>(c);
+
+        // One unit per lead byte, two for the leads of 4-byte sequences
+        length += static_cast<std::size_t>((u & 0xC0U) != 0x80U) + static_cast<std::size_t>(u >= 0xF0U);
+    }
+
+    return length;
+}
+
+std::size_t utf16_length(u32string_view str) noexcept
+{
+    std::size_t length = 0UL;
+
+    for (const char32_t c : str)
+    {
+        length += encoded_length<char16_t>(c);
+    }
+
+    return length;
+}
+
+std::size_t utf32_length(string_view str) noexcept
+{
+    std::size_t length = 0UL;
+
+    for (const char c : str)
+    {
+        length += static_cast<std::size_t>((static_cast<unsigned char>(c) & 0xC0U) != 0x80U);
+    }
+
+    return length;
+}
+
+std::size_t utf32_length(u16string_view str) noexcept
+{
+    std::size_t length = 0UL;
+
+    for (const char16_t c : str)
+    {
+        length += static_cast<std::size_t>((c & 0xFC00U) != 0xDC00U);
+    }
+
+    return length;
+}
+
+
+// Transcoding
+
+utf_result to_utf8(u16string_view str, char *out, std::size_t capacity) noexcept
+{
+    return transcode(str.data(), str.size(), out, capacity);
+}
+
+utf_result to_utf8(u32string_view str, char *out, std::size_t capacity) noexcept
+{
+    return transcode(str.data(), str.size(), out, capacity);
+}
+
+utf_result to_utf16(string_view str, char16_t *out, std::size_t capacity) noexcept
+{
+    return transcode(str.data(), str.size(), out, capacity);
+}
+
+utf_result to_utf16(u32string_view str, char16_t *out, std::size_t capacity) noexcept
+{
+    return transcode(str.data(), str.size(), out, capacity);
+}
+
+utf_result to_utf32(string_view str, char32_t *out, std::size_t capacity) noexcept
+{
+    return transcode(str.data(), str.size(), out, capacity);
+}
+
+utf_result to_utf32(u16string_view str, char32_t *out, std::size_t capacity) noexcept
+{
+    return transcode(str.data(), str.size(), out, capacity);
+}
@@ -0,0 +1,178 @@
+#include <cstring>
+
+#include "simd_avx2.hxx"
+#include "unicode_kernels.hxx"
+
+
+namespace string_view_detail
+{
+
+namespace
+{
+
+// Error classes of a pair of consecutive bytes, one bit each
+constexpr std::uint8_t too_short      = 1U << 0U;  // a continuation was due, but none came
+constexpr std::uint8_t too_long       = 1U << 1U;  // 0_______ 10______
+constexpr std::uint8_t overlong_3     = 1U << 2U;  // 11100000 100_____
+constexpr std::uint8_t too_large      = 1U << 3U;  // 11110100 1001____ and above
+constexpr std::uint8_t surrogate      = 1U << 4U;  // 11101101 101_____
+constexpr std::uint8_t overlong_2     = 1U << 5U;  // 1100000_ 10______
+constexpr std::uint8_t too_large_1000 = 1U << 6U;  // 11110101 1000____ and above
+constexpr std::uint8_t overlong_4     = 1U << 6U;  // 11110000 1000____
+constexpr std::uint8_t two_conts      = 1U << 7U;  // 10______ 10______
+
+constexpr std::uint8_t carry = too_short | too_long | two_conts;
+
+
+/***
+* @brief Looks each byte of \p index (0 to 15) up in a 16-entry table
+****/
+inline __m256i lookup(__m256i index, __m256i table) noexcept
+{
+    return _mm256_shuffle_epi8(table, index);
+}
+
+inline __m256i table(std::uint8_t t0, std::uint8_t t1, std::uint8_t t2, std::uint8_t t3,
+                     std::uint8_t t4, std::uint8_t t5, std::uint8_t t6, std::uint8_t t7,
+                     std::uint8_t t8, std::uint8_t t9, std::uint8_t t10, std::uint8_t t11,
+                     std::uint8_t t12, std::uint8_t t13, std::uint8_t t14, std::uint8_t t15) noexcept
+{
+    const __m128i half = _mm_setr_epi8(
+        static_cast<char>(t0), static_cast<char>(t1), static_cast<char>(t2), static_cast<char>(t3),
+        static_cast<char>(t4), static_cast<char>(t5), static_cast<char>(t6), static_cast<char>(t7),
+        static_cast<char>(t8), static_cast<char>(t9), static_cast<char>(t10), static_cast<char>(t11),
+        static_cast<char>(t12), static_cast<char>(t13), static_cast<char>(t14), static_cast<char>(t15));
+
+    return _mm256_broadcastsi128_si256(half);
+}
+
+inline __m256i high_nibbles(__m256i v) noexcept
+{
+    return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+}
+
+/***
+* @brief Returns \p input shifted by \p N bytes, the bytes shifted in
+*        coming from the end of \p previous
+****/
+template <int N>
+inline __m256i shift_in(__m256i input, __m256i previous) noexcept
+{
+    return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(previous, input, 0x21), 16 - N);
+}
+
+
+/***
+* @brief Lookup-table UTF-8 validation, 32 bytes at a time
+* \note  The algorithm of Keiser and Lemire, "Validating UTF-8 In Less
+*        Than One Instruction Per Byte". Three nibble lookups classify
+*        every pair of consecutive bytes; the errors they cannot see, a
+*        missing or extra third or fourth byte, are caught by checking
+*        that exactly the bytes two or three places after a 3- or 4-byte
+*        lead are flagged as continuations.
+****/
+struct utf8_checker
+{
+    __m256i error      = _mm256_setzero_si256();
+    __m256i previous   = _mm256_setzero_si256();  // the last block checked
+    __m256i incomplete = _mm256_setzero_si256();  // nonzero if it ends inside a sequence
+
+    void check(__m256i input) noexcept
+    {
+        if (_mm256_movemask_epi8(input) == 0)
+        {
+            // Pure ASCII, only a sequence left open by the last block can fail
+            this->error      = _mm256_or_si256(this->error, this->incomplete);
+            this->incomplete = _mm256_setzero_si256();
+            this->previous   = input;
+            return;
+        }
+
+        const __m256i prev1 = shift_in<1>(input, this->previous);
+
+        const __m256i byte_1_high = lookup(high_nibbles(prev1), table(
+            too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+            two_conts, two_conts, two_conts, two_conts,
+            too_short | overlong_2,
+            too_short,
+            too_short | overlong_3 | surrogate,
+            too_short | too_large | too_large_1000 | overlong_4));
+
+        const __m256i byte_1_low = lookup(_mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)), table(
+            carry | overlong_3 | overlong_2 | overlong_4,
+            carry | overlong_2,
+            carry,
+            carry,
+            carry | too_large,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000 | surrogate,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000));
+
+        const __m256i byte_2_high = lookup(high_nibbles(input), table(
+            too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+            too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+            too_long | overlong_2 | two_conts | overlong_3 | too_large,
+            too_long | overlong_2 | two_conts | surrogate | too_large,
+            too_long | overlong_2 | two_conts | surrogate | too_large,
+            too_short, too_short, too_short, too_short));
+
+        const __m256i special = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+        // Only the bytes two after a 111_____ lead or three after a
+        // 1111____ lead must be continuations that special flagged
+        const __m256i third  = _mm256_subs_epu8(shift_in<2>(input, this->previous), _mm256_set1_epi8(0xE0 - 0x80));
+        const __m256i fourth = _mm256_subs_epu8(shift_in<3>(input, this->previous), _mm256_set1_epi8(0xF0 - 0x80));
+        const __m256i must_continue = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(-128));
+
+        this->error = _mm256_or_si256(this->error, _mm256_xor_si256(must_continue, special));
+
+        // A lead in the last three bytes that its sequence does not fit in
+        const __m256i last_leads = _mm256_setr_epi8(
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+
+        this->incomplete = _mm256_subs_epu8(input, last_leads);
+        this->previous   = input;
+    }
+
+    bool valid() const noexcept
+    {
+        const __m256i all = _mm256_or_si256(this->error, this->incomplete);
+        return _mm256_testz_si256(all, all) != 0;
+    }
+};
+
+}  // namespace
+
+
+bool is_valid_utf8_avx2(const char *s, std::size_t n) noexcept
+{
+    utf8_checker checker;
+    std::size_t i = 0UL;
+
+    for (; (n - i) >= 32UL; i += 32UL)
+    {
+        checker.check(avx2_ops::load(s + i));
+    }
+
+    if (i < n)
+    {
+        // The padding is ASCII, so it also shows a sequence cut short
+        alignas(32) char tail[32] = {};
+        std::memcpy(tail, s + i, n - i);
+        checker.check(avx2_ops::load(tail));
+    }
+
+    return checker.valid();
+}
+
+}  // namespace string_view_detail
@@ -0,0 +1,25 @@
+/***********************************************
+** @Copyright (C) 2018 - 2019 Mohammed ELomari.
+** @brief Vectorized UTF-8 validation.
+************************************************/
+#ifndef STRING_VIEW_UNICODE_KERNELS_HXX
+#define STRING_VIEW_UNICODE_KERNELS_HXX
+
+
+#include <cstddef>
+
+
+namespace string_view_detail
+{
+
+/***
+* @brief AVX2 UTF-8 validator, built in unicode_avx2.cxx
+* @param s the bytes to check
+* @param n number of bytes in \p s
+* @return whether the bytes are well-formed UTF-8
+****/
+bool is_valid_utf8_avx2(const char *s, std::size_t n) noexcept;
+
+}  // namespace string_view_detail
+
+#endif